@@ -0,0 +1,81 @@
+// Times overlapBatch against the pairwise loop it replaced, one
+// CollisionDetector per box and check() per pair, for obstacle fields of
+// growing size. Build with -mavx (AabbBatchBenchmarkAvx) to time AVX.
+
+#include "AabbBatch.hpp"
+#include "AABB_CollisionDetection.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double nanosecondsPerBox(Clock::time_point start, Clock::time_point stop, long long boxes) {
+    return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(boxes);
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(2024u);
+    std::uniform_real_distribution<float> coordinate(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> extent(0.05f, 0.4f);
+
+    const int sizes[] = {16, 64, 256, 1024, 4096};
+    const long long BOXES_PER_SIZE = 20000000;
+
+    std::printf("AABB_BATCH_BENCHMARK:: width %d\n", aabbBatchWidth());
+    std::printf("%8s %14s %14s %8s\n", "boxes", "pairwise ns", "batch ns", "speedup");
+
+    for (int size : sizes) {
+        std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+        for (int i = 0; i < size; i++) {
+            glm::vec3 center(coordinate(rng), coordinate(rng), coordinate(rng));
+            glm::vec3 half(extent(rng), extent(rng), extent(rng));
+            minX.push_back(center.x - half.x);
+            minY.push_back(center.y - half.y);
+            minZ.push_back(center.z - half.z);
+            maxX.push_back(center.x + half.x);
+            maxY.push_back(center.y + half.y);
+            maxZ.push_back(center.z + half.z);
+        }
+        AabbColumns boxes = {minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data()};
+        glm::vec3 playerMin(-0.1f, -0.1f, -0.1005f);
+        glm::vec3 playerMax(0.1f, 0.1f, 0.1005f);
+        int repeats = static_cast<int>(BOXES_PER_SIZE / size);
+
+        // the sums keep the loops from being optimized away
+        long long pairwiseHits = 0;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < repeats; r++) {
+            CollisionDetector player(playerMin, playerMax);
+            for (int i = 0; i < size; i++) {
+                CollisionDetector box(glm::vec3(minX[i], minY[i], minZ[i]), glm::vec3(maxX[i], maxY[i], maxZ[i]));
+                pairwiseHits += player.check(box) ? 1 : 0;
+            }
+        }
+        Clock::time_point stop = Clock::now();
+        double pairwise = nanosecondsPerBox(start, stop, static_cast<long long>(repeats) * size);
+
+        long long batchHits = 0;
+        std::vector<std::uint64_t> hitMask;
+        start = Clock::now();
+        for (int r = 0; r < repeats; r++) {
+            overlapBatch(playerMin, playerMax, boxes, 0, size, hitMask);
+            for (std::size_t word = 0; word < hitMask.size(); word++) {
+                batchHits += hitMask[word] ? 1 : 0;
+            }
+        }
+        stop = Clock::now();
+        double batch = nanosecondsPerBox(start, stop, static_cast<long long>(repeats) * size);
+
+        std::printf("%8d %14.3f %14.3f %7.1fx%s\n", size, pairwise, batch, pairwise / batch,
+                    (pairwiseHits == 0) != (batchHits == 0) ? "  (hit counts disagree)" : "");
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Times one draw of CounterRng against the std::mt19937 and standard
+// distributions ChunkGenerator used before, for floats and lane indices.
+
+#include "CounterRng.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int DRAWS = 50000000;
+
+double nanosecondsPerDraw(Clock::time_point start, Clock::time_point stop) {
+    return std::chrono::duration<double, std::nano>(stop - start).count() / DRAWS;
+}
+
+} // namespace
+
+int main() {
+    // the sums keep the loops from being optimized away
+    double sum = 0.0;
+    long long laneSum = 0;
+
+    std::mt19937 engine(42u);
+    std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < DRAWS; i++) {
+        sum += jitter(engine);
+    }
+    double mtFloat = nanosecondsPerDraw(start, Clock::now());
+
+    std::uniform_int_distribution<int> lane(0, 2);
+    start = Clock::now();
+    for (int i = 0; i < DRAWS; i++) {
+        laneSum += lane(engine);
+    }
+    double mtInt = nanosecondsPerDraw(start, Clock::now());
+
+    CounterRng rng(42u, 7u);
+    start = Clock::now();
+    for (int i = 0; i < DRAWS; i++) {
+        sum += rng.uniform(static_cast<std::uint64_t>(i), -0.3f, 0.3f);
+    }
+    double counterFloat = nanosecondsPerDraw(start, Clock::now());
+
+    start = Clock::now();
+    for (int i = 0; i < DRAWS; i++) {
+        laneSum += rng.uniformInt(static_cast<std::uint64_t>(i), 0, 2);
+    }
+    double counterInt = nanosecondsPerDraw(start, Clock::now());
+
+    std::printf("%-40s %10s %10s\n", "ns per draw", "float", "int");
+    std::printf("%-40s %10.2f %10.2f\n", "mt19937 + uniform_*_distribution", mtFloat, mtInt);
+    std::printf("%-40s %10.2f %10.2f\n", "CounterRng", counterFloat, counterInt);
+    std::printf("(checksum %f %lld)\n", sum, laneSum);
+    return 0;
+}
@@ -1,7 +1,9 @@
+#ifndef AABB_COLLISIONDETECTION_HPP
 #define AABB_COLLISIONDETECTION_HPP
 
 #include <glm/glm.hpp>
 #include <vector>
+#include "ObstacleCatalog.hpp"
 #include "Player.hpp"
 
 class CollisionDetector {
@@ -9,8 +11,12 @@ public:
     CollisionDetector();
     CollisionDetector(glm::vec3 min, glm::vec3 max);
     void getPlayer(const Player& player, float groundLevel);
-    void getObstacle(const glm::vec3& position, int obsType);
+    void getObstacle(const glm::vec3& position, ObstacleKind kind);
     bool check(const CollisionDetector& b);
+    // continuous version of check: moves this box by displacement and
+    // reports the first moment of contact with b as a fraction of the
+    // motion in [0, 1]; toi is 0 when the boxes already overlap
+    bool sweep(const glm::vec3& displacement, const CollisionDetector& b, float& toi) const;
     const glm::vec3 &getMin() const;
     const glm::vec3 &getMax() const;
 
@@ -19,3 +25,4 @@ private:
     glm::vec3 max;
 };
 
+#endif // AABB_COLLISIONDETECTION_HPP
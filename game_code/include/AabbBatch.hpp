@@ -0,0 +1,33 @@
+#ifndef AABB_BATCH_HPP
+#define AABB_BATCH_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Boxes stored one column per coordinate, e.g. by ObstacleStore.
+struct AabbColumns {
+    const float *minX;
+    const float *minY;
+    const float *minZ;
+    const float *maxX;
+    const float *maxY;
+    const float *maxZ;
+};
+
+// Boxes per instruction in this build: 8, 4 or 1.
+int aabbBatchWidth();
+
+// Tests one box against the columns [begin, end) several boxes at a time:
+// 8 per instruction with AVX, 4 with SSE, one by one otherwise, whichever
+// the compiler targets; defining AABB_BATCH_SCALAR forces one by one.
+// Overlap is inclusive on every axis, exactly like CollisionDetector::check.
+//
+// Bit i of hitMask (word i / 64, bit i % 64) is set when box begin + i
+// overlaps; the mask is resized to fit. Returns the index of the first
+// overlapping box, or -1.
+int overlapBatch(const glm::vec3 &min, const glm::vec3 &max, const AabbColumns &boxes, int begin, int end,
+                 std::vector<std::uint64_t> &hitMask);
+
+#endif // AABB_BATCH_HPP
@@ -0,0 +1,68 @@
+#ifndef BOX_RING_HPP
+#define BOX_RING_HPP
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "AabbBatch.hpp"
+
+// Fixed-capacity ring of boxes, one array per coordinate, shared by the
+// stores of things placed along the run.
+//
+// Boxes are appended at the far end and evicted from the near end once the
+// player is past them, so the live slots are always ordered by distance and
+// form at most two contiguous index ranges. There are no empty slots to
+// skip: a loop over liveRanges() touches live slots only. A store derives
+// from the ring and keeps its own columns next to the box columns, indexed
+// by the same slots.
+class BoxRing {
+public:
+    // [begin, end) slot indices
+    struct Range {
+        int begin;
+        int end;
+    };
+
+    explicit BoxRing(int capacity);
+
+    // evicts the nearest box, the one in slot oldest()
+    void popOldest();
+    void clear();
+
+    // fills ranges, returns how many of the two are used
+    int liveRanges(Range ranges[2]) const;
+    // slots of the nearest and the farthest box, -1 when empty
+    int oldest() const;
+    int newest() const;
+
+    int size() const;
+    int capacity() const;
+    bool empty() const;
+    bool full() const;
+
+    const float *minX() const;
+    const float *minY() const;
+    const float *minZ() const;
+    const float *maxX() const;
+    const float *maxY() const;
+    const float *maxZ() const;
+    // all six box columns, for overlapBatch
+    AabbColumns boxes() const;
+
+protected:
+    // appends the box and returns its slot, -1 and nothing stored when the
+    // ring is full
+    int pushBox(const glm::vec3 &min, const glm::vec3 &max);
+
+private:
+    int slotCapacity;
+    // oldest live slot and number of live slots
+    int head = 0;
+    int count = 0;
+
+    std::vector<float> minXColumn, minYColumn, minZColumn;
+    std::vector<float> maxXColumn, maxYColumn, maxZColumn;
+};
+
+#endif // BOX_RING_HPP
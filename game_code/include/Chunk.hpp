@@ -0,0 +1,34 @@
+#ifndef CHUNK_HPP
+#define CHUNK_HPP
+
+#include "ObstacleCatalog.hpp"
+
+// one obstacle of a chunk, distance is measured along the run from the start
+struct ObstacleSpawn {
+    ObstacleKind kind;
+    int lane;
+    float distance;
+};
+
+// one coin of a chunk, height is its center above the standing player's
+struct CoinSpawn {
+    int lane;
+    float distance;
+    float height;
+};
+
+// The obstacles and coins of one chunkLength long stretch of the run,
+// nearest first. Fixed size so chunks can be copied through the queue
+// without allocating.
+struct Chunk {
+    static const int MAX_OBSTACLES = 4;
+    static const int MAX_COINS = 24;
+
+    float startDistance;
+    int count;
+    ObstacleSpawn obstacles[MAX_OBSTACLES];
+    int coinCount;
+    CoinSpawn coins[MAX_COINS];
+};
+
+#endif // CHUNK_HPP
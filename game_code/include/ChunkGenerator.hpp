@@ -0,0 +1,98 @@
+#ifndef CHUNK_GENERATOR_HPP
+#define CHUNK_GENERATOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Chunk.hpp"
+#include "CounterRng.hpp"
+#include "SolvabilityChecker.hpp"
+#include "SpscQueue.hpp"
+
+// Builds the run ahead of the player on a worker thread.
+//
+// Every chunk is one pattern drawn from a weighted library of authored
+// obstacle arrangements, placed with some random jitter. The draws are
+// keyed by the run seed, the chunk index and a slot, so a seed always
+// gives the same track and any chunk's draws can be redone on their own.
+// The checker then
+// follows every way the player could take from the end of the previous
+// chunk; a chunk nobody could get through is drawn again, and after a few
+// tries its far obstacles are dropped until it can be passed. Finished
+// chunks go into a lock-free queue that the worker keeps topped up; the
+// simulation only takes chunks out of it, so whatever the pattern logic
+// and the check cost is never paid inside a frame. The queue is filled
+// before the worker starts, so the first chunks are there from the
+// beginning.
+//
+// Coins come in evenly spaced trails along a lane, and a trail mostly
+// carries on in the lane of the previous one. Coins next to an obstacle the
+// player has to jump are lifted onto the jump, and coins that would still
+// end up inside an obstacle are left out.
+class ChunkGenerator {
+public:
+    // checker must cut the run into chunks of the same chunkLength
+    ChunkGenerator(const std::vector<float> &lanes, float chunkLength, float startDistance, int lookAhead,
+                   std::uint64_t seed, const SolvabilityChecker &checker);
+    ~ChunkGenerator();
+
+    ChunkGenerator(const ChunkGenerator &) = delete;
+    ChunkGenerator &operator=(const ChunkGenerator &) = delete;
+
+    // consumer: the next chunk, nullptr when the worker fell behind.
+    // Stays valid until pop().
+    const Chunk *front() const;
+    void pop();
+
+private:
+    void run();
+    Chunk generate();
+    // one attempt at a chunk from the rng slots starting at firstSlot
+    Chunk build(float startDistance, const CounterRng &rng, std::uint64_t firstSlot);
+    int pickPattern(const CounterRng &rng, std::uint64_t slot);
+    // checks chunk from the reachable states left by the previous one and
+    // moves them to its end when it can be passed
+    bool passable(const Chunk &chunk);
+    void placeCoins(Chunk &chunk, const CounterRng &rng);
+    void addTrail(Chunk &chunk, int lane) const;
+    // whether an obstacle of chunk or the previous one covers lane between
+    // bottom and top, within reach of distance in front or behind its box;
+    // heights are above the obstacles' ground
+    bool obstacleNear(const Chunk &chunk, int lane, float distance, float reach, float bottom, float top) const;
+
+    std::vector<float> lanes;
+    int laneCount;
+    float chunkLength;
+    float nextDistance;
+
+    std::uint64_t seed;
+
+    // only touched by whoever produces, first the constructor, then run()
+    std::uint64_t chunkIndex = 0;
+    SolvabilityChecker checker;
+    // the standing ball above the obstacles' ground and the height of a
+    // jump, as the checker measured them on the Player; coin heights are
+    // relative to the ball's center
+    float ballBottom, ballTop;
+    float coinJumpHeight;
+    // where the player can be at the far edge of the previous chunk
+    SolvabilityChecker::StateSet reach;
+    // its obstacles can still be in the way early in the next chunk
+    Chunk previous;
+    // lane of the last coin trail, -1 when the previous chunk had none
+    int coinLane = -1;
+
+    SpscQueue<Chunk> queue;
+
+    // the worker sleeps here while the queue is full
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping;
+    std::thread worker;
+};
+
+#endif // CHUNK_GENERATOR_HPP
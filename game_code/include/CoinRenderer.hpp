@@ -0,0 +1,44 @@
+#ifndef COIN_RENDERER_HPP
+#define COIN_RENDERER_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "CoinStore.hpp"
+#include "MeshBuilder.hpp"
+#include "Shader.hpp"
+
+// Draws every coin slot of a CoinStore with one instanced call.
+//
+// The GPU keeps its own copy of the slots, a position and a visible flag
+// each, and the CPU only writes the slots named by CoinUpdates: a coin
+// placed, collected or left behind. Hidden slots are still drawn and
+// dropped by the vertex shader, which also spins the coins, so the CPU
+// work per frame depends on how many coins changed, never on how many are
+// on screen.
+class CoinRenderer {
+public:
+    explicit CoinRenderer(int capacity);
+
+    void apply(const std::vector<CoinUpdate> &updates);
+    // opaque, after the scene; time drives the spin
+    void draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition, float time);
+    void release();
+
+    int getCapacity() const;
+
+private:
+    int capacity;
+
+    Shader shader;
+    Mesh coinMesh;
+    SubMesh coin;
+    // one vec4 per slot: position, visible
+    GLuint instanceVBO = 0;
+    // a run of consecutive slots is uploaded with one call
+    std::vector<glm::vec4> staging;
+};
+
+#endif // COIN_RENDERER_HPP
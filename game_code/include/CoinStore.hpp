@@ -0,0 +1,47 @@
+#ifndef COIN_STORE_HPP
+#define COIN_STORE_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "BoxRing.hpp"
+
+// half the size of a coin's collision box on every axis; a spinning coin
+// sweeps a cylinder, the box covers it at any angle
+constexpr float COIN_RADIUS = 0.06f;
+
+// Tells the renderer what changed in one coin slot: a coin was placed
+// there, or the coin there was collected or left behind.
+struct CoinUpdate {
+    int slot;
+    glm::vec3 position;
+    bool visible;
+};
+
+// The coins of the run, one array per field, on a BoxRing like the
+// obstacles, so the live slots are ordered by distance. Collected coins
+// keep their slot until they are evicted, one bit each in the collected
+// set.
+class CoinStore : public BoxRing {
+public:
+    explicit CoinStore(int capacity);
+
+    // false, and nothing stored, when the store is full
+    bool push(const glm::vec3 &position);
+
+    bool isCollected(int slot) const;
+    void collect(int slot);
+
+    const float *positionX() const;
+    const float *positionY() const;
+    const float *positionZ() const;
+
+private:
+    std::vector<float> xColumn, yColumn, zColumn;
+    // bit slot % 64 of word slot / 64
+    std::vector<std::uint64_t> collected;
+};
+
+#endif // COIN_STORE_HPP
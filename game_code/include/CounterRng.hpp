@@ -0,0 +1,44 @@
+#ifndef COUNTER_RNG_HPP
+#define COUNTER_RNG_HPP
+
+#include <cstdint>
+
+// Counter-based random numbers: the value in a slot is a pure function of
+// the key and the slot number, the SplitMix64 finalizer applied to
+// key + slot * golden ratio. Nothing is stored but the key, any slot can be
+// read in any order from any thread, and the same key gives the same values
+// on every platform, unlike the standard distributions whose results are
+// up to the library.
+class CounterRng {
+public:
+    // one independent sequence per (seed, stream) pair
+    CounterRng(std::uint64_t seed, std::uint64_t stream) : key(mix(seed ^ mix(stream + GOLDEN))) {}
+
+    std::uint64_t bits(std::uint64_t slot) const { return mix(key + (slot + 1) * GOLDEN); }
+
+    // in [lo, hi)
+    float uniform(std::uint64_t slot, float lo, float hi) const {
+        // the top 24 bits fill a float mantissa exactly
+        float unit = static_cast<float>(bits(slot) >> 40) * (1.0f / 16777216.0f);
+        return lo + (hi - lo) * unit;
+    }
+
+    // in [lo, hi], by multiply and shift; the bias is below 2^-32
+    int uniformInt(std::uint64_t slot, int lo, int hi) const {
+        std::uint64_t range = static_cast<std::uint64_t>(hi - lo) + 1;
+        return lo + static_cast<int>(((bits(slot) >> 32) * range) >> 32);
+    }
+
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static const std::uint64_t GOLDEN = 0x9e3779b97f4a7c15ull;
+
+    std::uint64_t key;
+};
+
+#endif // COUNTER_RNG_HPP
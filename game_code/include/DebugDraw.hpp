@@ -0,0 +1,71 @@
+#ifndef DEBUG_DRAW_HPP
+#define DEBUG_DRAW_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Shader.hpp"
+
+struct DebugVertex {
+    glm::vec3 position;
+    std::uint32_t color; // RGBA8, see DebugDraw::rgba
+};
+
+// Immediate-mode lines and boxes for diagnostics, callable from anywhere on
+// the main thread while a frame is being recorded. Everything lands in the
+// frame's line list and reaches the GPU as a single GL_LINES draw.
+//
+// When disabled every call returns after one branch and the list stays
+// empty, so the render thread skips the pass as well. Callers that need
+// work just to produce their shapes should check isEnabled() first.
+class DebugDraw {
+public:
+    static void setEnabled(bool enabled) { active = enabled; }
+    static bool isEnabled() { return active; }
+
+    // starts recording into `lines` (cleared first), nullptr stops recording
+    static void begin(std::vector<DebugVertex> *lines);
+
+    static void line(const glm::vec3 &from, const glm::vec3 &to, std::uint32_t color) {
+        if (active && target) {
+            addLine(from, to, color);
+        }
+    }
+    static void box(const glm::vec3 &min, const glm::vec3 &max, std::uint32_t color) {
+        if (active && target) {
+            addBox(min, max, color);
+        }
+    }
+
+    static std::uint32_t rgba(float r, float g, float b, float a = 1.0f);
+
+private:
+    static void addLine(const glm::vec3 &from, const glm::vec3 &to, std::uint32_t color);
+    static void addBox(const glm::vec3 &min, const glm::vec3 &max, std::uint32_t color);
+
+    static bool active;
+    static std::vector<DebugVertex> *target;
+};
+
+// The render thread half: one streaming vertex buffer, orphaned and
+// refilled every frame, and a shader that passes the vertex color through.
+// Lines are drawn without depth testing so boxes stay visible inside the
+// meshes they describe.
+class DebugDrawRenderer {
+public:
+    DebugDrawRenderer();
+
+    void draw(const std::vector<DebugVertex> &lines, const glm::mat4 &viewProjection);
+    void release();
+
+private:
+    Shader shader;
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLsizeiptr capacity = 0;
+};
+
+#endif // DEBUG_DRAW_HPP
@@ -0,0 +1,56 @@
+#ifndef DYNAMIC_RESOLUTION_HPP
+#define DYNAMIC_RESOLUTION_HPP
+
+#include <glad/glad.h>
+
+// Renders the 3D scene into an offscreen framebuffer at a fraction of the
+// window resolution and upscales it into the default framebuffer.
+//
+// The fraction is picked by a controller fed from GL_TIME_ELAPSED queries
+// around the scene pass. Queries are read back a few frames late, so they
+// never stall the pipeline. GPU time is assumed to scale with the number of
+// shaded pixels, i.e. with scale^2.
+class DynamicResolution {
+public:
+    static const int QUERY_COUNT = 4;
+
+    DynamicResolution(int windowWidth, int windowHeight, float targetSceneMs);
+
+    // (re)allocates the offscreen targets when the window size changed
+    void resize(int windowWidth, int windowHeight);
+    // binds the offscreen framebuffer and sets the scaled viewport
+    void beginScene();
+    // upscales the scene into the default framebuffer, which is left bound
+    // with a full-window viewport and a cleared depth buffer for the HUD
+    void endScene();
+    void release();
+
+    float getScale() const;
+    float getSceneMs() const;
+    int getSceneWidth() const;
+    int getSceneHeight() const;
+
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+
+private:
+    void allocateTargets();
+    void readQueries();
+    void updateScale(float sceneMs);
+
+    int windowWidth, windowHeight;
+    float targetSceneMs;
+    float scale = 1.0f;
+    float smoothedSceneMs = 0.0f;
+    bool enabled = true;
+
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;
+    GLuint depthBuffer = 0;
+
+    GLuint queries[QUERY_COUNT] = {};
+    bool queryPending[QUERY_COUNT] = {};
+    int queryIndex = 0;
+};
+
+#endif // DYNAMIC_RESOLUTION_HPP
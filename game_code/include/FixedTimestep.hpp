@@ -0,0 +1,25 @@
+#ifndef FIXED_TIMESTEP_HPP
+#define FIXED_TIMESTEP_HPP
+
+// Accumulates real frame time and hands it out in constant simulation
+// steps. Whatever is left over is the interpolation factor between the
+// last two simulation states.
+class FixedTimestep {
+public:
+    // maxFrameTime bounds the catch-up after a long hitch so a slow machine
+    // cannot end up simulating more than it renders
+    explicit FixedTimestep(double step, double maxFrameTime = 0.25);
+
+    // adds the time of one rendered frame, returns the number of steps due
+    int advance(double frameTime);
+    float getStep() const;
+    // 0 = previous state, 1 = current state
+    float getAlpha() const;
+
+private:
+    double step;
+    double maxFrameTime;
+    double accumulator = 0.0;
+};
+
+#endif // FIXED_TIMESTEP_HPP
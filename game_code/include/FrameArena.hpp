@@ -0,0 +1,81 @@
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Bump allocator for data that only lives for one frame.
+//
+// Allocating moves an offset through one block taken up front, freeing does
+// nothing, and reset() at the start of the next frame gives the whole block
+// back at once. A frame that needs more than the budget does not fail: the
+// rest comes from the heap until the next reset, and the overflow is
+// reported so the budget can be raised. Only one thread may use an arena
+// at a time; data handed to another thread goes into an arena per hand-over
+// slot, see RenderFrame::arena.
+class FrameArena {
+public:
+    FrameArena(std::size_t capacity, const char *name);
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    void *allocate(std::size_t size, std::size_t alignment);
+    // ends the frame: everything allocated since the last reset is gone
+    void reset();
+
+    // printf into the arena, for text that only has to last the frame
+    const char *format(const char *format, ...);
+
+    std::size_t getUsed() const { return used; }
+    std::size_t getCapacity() const { return capacity; }
+    // most bytes a single frame ever asked for, overflow included
+    std::size_t getHighWater() const { return highWater; }
+
+private:
+    char *block;
+    std::size_t capacity;
+    std::size_t used = 0;
+    std::string name;
+
+    // this frame's allocations that did not fit, freed by reset()
+    std::vector<void *> spills;
+    std::size_t spilled = 0;
+    std::size_t highWater = 0;
+    // largest overflow reported so far, smaller ones stay quiet
+    std::size_t reportedOverflow = 0;
+};
+
+// std::allocator interface on top of a FrameArena, for standard containers
+// that only live for one frame. The arena must outlive the container and
+// must not be reset while the container is still in use.
+template <typename T> class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(FrameArena &arena) : arena(&arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.getArena()) {}
+
+    T *allocate(std::size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *, std::size_t) {}
+
+    FrameArena *getArena() const { return arena; }
+
+private:
+    FrameArena *arena;
+};
+
+template <typename T, typename U> bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U> bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+    return a.getArena() != b.getArena();
+}
+
+// a vector that lives in a FrameArena
+template <typename T> using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_HPP
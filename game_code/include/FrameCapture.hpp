@@ -0,0 +1,109 @@
+#ifndef FRAME_CAPTURE_HPP
+#define FRAME_CAPTURE_HPP
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Screenshots and continuous recording without stalling the GPU.
+//
+// capture() starts a glReadPixels of the back buffer into one pixel buffer
+// object of a small ring and fences it. The buffer is only mapped once its
+// fence has signalled, normally one or two frames later. The pixels are
+// copied out and handed to a worker thread, which encodes screenshots as
+// PNG and appends recorded frames to a raw Y4M (4:2:0) stream that external
+// tools can encode afterwards.
+//
+// A recording never waits: when the ring or the worker queue is full the
+// frame is dropped and counted. Only a screenshot waits for a free buffer.
+class FrameCapture {
+public:
+    static const int RING_SIZE = 3;
+    typedef std::chrono::steady_clock Clock;
+
+    FrameCapture();
+
+    // one PNG of the next captured frame
+    void requestScreenshot();
+    void setRecording(bool enabled);
+    bool isRecording() const;
+
+    // reads back the finished frame in the default framebuffer, call after
+    // the HUD and right before swapping
+    void capture(int width, int height);
+    // waits for outstanding readbacks, closes the recording, stops the worker
+    void release();
+
+    // the Y4M stream is written at this fixed rate, slow frames are repeated
+    double recordFps = 60.0;
+    // frames waiting for the encoder before new ones are dropped
+    std::size_t maxQueuedFrames = 8;
+    std::string directory = "../captures/";
+
+private:
+    enum class JobType { SCREENSHOT, VIDEO_START, VIDEO_FRAME, VIDEO_END };
+
+    struct Job {
+        JobType type;
+        std::string path;
+        int width;
+        int height;
+        int repeat;
+        // RGBA8, top row first
+        std::vector<unsigned char> pixels;
+    };
+
+    struct Readback {
+        GLuint pbo;
+        GLsizeiptr size;
+        GLsync fence;
+        JobType type;
+        int width;
+        int height;
+        int repeat;
+    };
+
+    void startReadback(JobType type, int width, int height, int repeat);
+    // maps a finished readback and queues it, false while the GPU is busy
+    bool finishReadback(Readback &readback, bool wait);
+    void collectReadbacks(bool wait);
+    void enqueue(Job &job);
+    std::string makePath(const char *prefix, const char *extension);
+
+    void workerLoop();
+    void writeScreenshot(const Job &job);
+    void writeVideoFrame(const Job &job);
+
+    // render thread
+    Readback ring[RING_SIZE];
+    int next = 0;
+    bool screenshotRequested = false;
+    bool recording = false;
+    Clock::time_point recordStart;
+    long long recordedFrames = 0;
+    int droppedFrames = 0;
+    int captureCounter = 0;
+
+    // shared with the worker
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    std::vector<std::vector<unsigned char>> spareBuffers;
+    bool stopping = false;
+    std::thread worker;
+
+    // worker only
+    std::ofstream video;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    std::vector<unsigned char> videoPlanes;
+};
+
+#endif // FRAME_CAPTURE_HPP
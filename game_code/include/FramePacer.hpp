@@ -0,0 +1,64 @@
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <chrono>
+
+enum class SwapMode { VSYNC, ADAPTIVE_VSYNC, IMMEDIATE };
+
+// Keeps the frame cadence predictable and the power draw low.
+//
+// The swap interval follows the selected SwapMode. On top of that an
+// optional frame cap is enforced before the swap: the pacer sleeps for most
+// of the remaining time and only spins for the last, OS-timer-sized part.
+// In low-power mode the cap drops to lowPowerFps and the spin is skipped
+// entirely, trading a little jitter for an idle core.
+//
+// Every frame interval is recorded and mean / jitter are reported once per
+// reportInterval seconds.
+class FramePacer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    FramePacer(SwapMode mode, double frameCap);
+
+    // applies the swap interval, needs the GL context to be current
+    void setSwapMode(SwapMode mode);
+    // 0 means uncapped
+    void setFrameCap(double fps);
+    void setLowPower(bool enabled);
+
+    SwapMode getSwapMode() const;
+    bool isLowPower() const;
+
+    // blocks until the next frame is due, call right before swapping
+    void waitForNextFrame();
+    // call right after swapping
+    void endFrame();
+
+    double lowPowerFps = 30.0;
+    double reportInterval = 5.0;
+
+private:
+    double activeCap() const;
+    void report();
+
+    SwapMode swapMode;
+    double frameCap;
+    bool lowPower = false;
+
+    Clock::time_point deadline;
+    bool deadlineValid = false;
+    // how much earlier than the deadline sleeping stops, grows with the
+    // oversleep the OS scheduler actually shows
+    double spinMargin = 0.002;
+
+    Clock::time_point lastFrameEnd;
+    bool lastFrameValid = false;
+    Clock::time_point reportStart;
+    int frames = 0;
+    double intervalSum = 0.0;
+    double intervalSquareSum = 0.0;
+    double worstInterval = 0.0;
+};
+
+#endif // FRAME_PACER_HPP
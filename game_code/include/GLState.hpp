@@ -0,0 +1,63 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include <glad/glad.h>
+
+// Shadow copy of the GL state the game changes, so redundant binds and
+// toggles never reach the driver.
+//
+// Every state change of the render thread goes through here. A call whose
+// value matches the shadow is counted as skipped and dropped; anything else
+// is forwarded and recorded. Texture units are selected lazily, only when a
+// bind on another unit actually has to happen.
+//
+// The shadow starts out unknown, so the first call of every kind always
+// reaches GL. Deleting a bound object unbinds it in GL, the delete wrappers
+// keep the shadow in sync with that. Not covered: framebuffers, viewport
+// and the element array buffer, which is part of the VAO state.
+class GLState {
+public:
+    enum Counter {
+        PROGRAM,
+        VERTEX_ARRAY,
+        BUFFER,
+        TEXTURE,
+        CAPABILITY,
+        BLEND_FUNC,
+        DEPTH,
+        COLOR_MASK,
+        COUNTER_COUNT
+    };
+
+    static const int MAX_TEXTURE_UNITS = 16;
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vertexArray);
+    // GL_ARRAY_BUFFER, GL_PIXEL_PACK_BUFFER and GL_TEXTURE_BUFFER are
+    // cached, other targets are forwarded unchanged
+    static void bindBuffer(GLenum target, GLuint buffer);
+    // GL_TEXTURE_2D and GL_TEXTURE_BUFFER are cached per unit
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+    // GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND and GL_RASTERIZER_DISCARD
+    static void setEnabled(GLenum capability, bool enabled);
+    static void blendFunc(GLenum source, GLenum destination);
+    static void depthFunc(GLenum function);
+    static void depthMask(bool enabled);
+    static void colorMask(bool enabled);
+
+    static void deleteProgram(GLuint program);
+    static void deleteVertexArrays(GLsizei count, const GLuint *vertexArrays);
+    static void deleteBuffers(GLsizei count, const GLuint *buffers);
+    static void deleteTextures(GLsizei count, const GLuint *textures);
+
+    // forgets the whole shadow, for code that changed state behind its back
+    static void invalidate();
+
+    static unsigned long long getIssued(Counter counter);
+    static unsigned long long getSkipped(Counter counter);
+    // prints issued / skipped per kind as GL_STATE:: and resets the counters
+    static void report();
+    static void resetCounters();
+};
+
+#endif // GL_STATE_HPP
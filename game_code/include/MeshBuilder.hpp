@@ -0,0 +1,93 @@
+#ifndef MESH_BUILDER_HPP
+#define MESH_BUILDER_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "VertexFormat.hpp"
+
+// A range of the index buffer that is drawn with one material
+struct SubMesh {
+    GLuint firstIndex;
+    GLsizei indexCount;
+};
+
+// Indexed triangle list in the packed vertex format
+struct Mesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<GLuint> indices;
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+
+    // creates the VAO and static buffers, binds nothing afterwards
+    void upload();
+    void draw(const SubMesh &subMesh) const;
+    void release();
+};
+
+// Average cache miss ratio of the post-transform cache before and after
+// MeshBuilder::optimize; 3.0 means every vertex is transformed again for
+// every triangle, 0.5 is the practical lower bound for regular grids.
+struct MeshStats {
+    float acmrBefore;
+    float acmrAfter;
+};
+
+// Builds procedural geometry as indexed triangles. Identical vertices are
+// shared, and optimize() reorders triangles for the post-transform vertex
+// cache (Forsyth's linear-speed algorithm) and vertices for fetch locality.
+class MeshBuilder {
+public:
+    // a single quad, corners given counter-clockwise
+    SubMesh addQuad(const glm::vec3 corners[4], const glm::vec2 texCoords[4], const glm::vec3 &normal);
+    // `segments` quads between the edges (startA, startB) and (endA, endB)
+    SubMesh addQuadStrip(const glm::vec3 &startA, const glm::vec3 &startB, const glm::vec3 &endA,
+                         const glm::vec3 &endB, int segments, const glm::vec2 &texRepeat, const glm::vec3 &normal);
+    // open cylinder around the segment base -> base + axis
+    SubMesh addCylinder(const glm::vec3 &base, const glm::vec3 &axis, float radius, int segments,
+                        const glm::vec2 &texRepeat);
+    // disc facing `normal`, uses the same ring as addCylinder
+    SubMesh addCap(const glm::vec3 &center, const glm::vec3 &normal, float radius, int segments);
+    // UV sphere with its poles on the z axis
+    SubMesh addSphere(const glm::vec3 &center, float radius, int sectors, int stacks);
+
+    // Reorders triangles inside every sub mesh and then the vertices of the
+    // whole mesh. Sub mesh ranges stay valid.
+    MeshStats optimize();
+
+    Mesh build() const;
+
+    static float acmr(const std::vector<GLuint> &indices, std::size_t first, std::size_t count,
+                      std::size_t cacheSize = 16);
+
+private:
+    GLuint addVertex(const glm::vec3 &position, const glm::vec2 &texCoord, const glm::vec3 &normal);
+    void addTriangle(GLuint a, GLuint b, GLuint c);
+    SubMesh beginSubMesh() const;
+    SubMesh endSubMesh(SubMesh subMesh);
+    void optimizeTriangles(std::size_t first, std::size_t count);
+    void optimizeFetch();
+
+    struct VertexKey {
+        std::uint64_t low;
+        std::uint64_t high;
+        bool operator==(const VertexKey &other) const { return low == other.low && high == other.high; }
+    };
+    struct VertexKeyHash {
+        std::size_t operator()(const VertexKey &key) const {
+            return static_cast<std::size_t>(key.low * 0x9E3779B97F4A7C15ull ^ key.high);
+        }
+    };
+
+    std::vector<PackedVertex> vertices;
+    std::vector<GLuint> indices;
+    std::vector<SubMesh> subMeshes;
+    std::unordered_map<VertexKey, GLuint, VertexKeyHash> vertexLookup;
+};
+
+#endif // MESH_BUILDER_HPP
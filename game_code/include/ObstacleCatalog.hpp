@@ -0,0 +1,51 @@
+#ifndef OBSTACLE_CATALOG_HPP
+#define OBSTACLE_CATALOG_HPP
+
+#include <cstdint>
+
+#include "RenderIds.hpp"
+
+enum class ObstacleKind : std::uint8_t { TRUNK, DOWN_TRUNK, UP_TRUNK, COUNT };
+
+// ObstacleTraits::lane value for obstacles placed in a random lane
+constexpr int ANY_LANE = -1;
+
+struct ObstacleTraits {
+    // collision box relative to (lane x, ground level, z) of the obstacle
+    float boxMin[3];
+    float boxMax[3];
+    // every mesh is drawn with its texture and the obstacle's translation
+    int meshCount;
+    MeshId meshes[2];
+    TextureId textures[2];
+    // lane index, or ANY_LANE
+    int lane;
+};
+
+// Every obstacle type, one row per ObstacleKind in enum order. Collision
+// boxes, drawing and spawning all read from here; a new type is a new enum
+// value and a new row.
+constexpr ObstacleTraits OBSTACLE_CATALOG[] = {
+    // TRUNK: standing trunk, dodge it
+    {{-0.1f, 0.0f, -0.101f}, {0.1f, 0.3f, 0.101f},
+     2, {MeshId::TRUNK_TOP, MeshId::TRUNK_SIDE}, {TextureId::CIRCLE_TRUNK, TextureId::TRUNK},
+     ANY_LANE},
+    // DOWN_TRUNK: fallen across the path, jump over it
+    {{-6.0f, 0.0f, -0.101f}, {6.0f, 0.2f, 0.101f},
+     1, {MeshId::DOWN_TRUNK, MeshId::DOWN_TRUNK}, {TextureId::FALLEN_TRUNK, TextureId::FALLEN_TRUNK},
+     1},
+    // UP_TRUNK: raised across the path, crouch under it
+    {{-7.0f, 0.3f, -0.101f}, {7.0f, 0.5f, 0.101f},
+     1, {MeshId::UP_TRUNK, MeshId::UP_TRUNK}, {TextureId::FALLEN_TRUNK, TextureId::FALLEN_TRUNK},
+     1},
+};
+
+constexpr int OBSTACLE_KIND_COUNT = static_cast<int>(ObstacleKind::COUNT);
+static_assert(sizeof(OBSTACLE_CATALOG) / sizeof(OBSTACLE_CATALOG[0]) == OBSTACLE_KIND_COUNT,
+              "OBSTACLE_CATALOG needs exactly one row per ObstacleKind");
+
+constexpr const ObstacleTraits &obstacleTraits(ObstacleKind kind) {
+    return OBSTACLE_CATALOG[static_cast<int>(kind)];
+}
+
+#endif // OBSTACLE_CATALOG_HPP
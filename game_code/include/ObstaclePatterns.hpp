@@ -0,0 +1,45 @@
+#ifndef OBSTACLE_PATTERNS_HPP
+#define OBSTACLE_PATTERNS_HPP
+
+#include "Chunk.hpp"
+#include "ObstacleCatalog.hpp"
+
+// lane value of a pattern spawn that follows the kind's own lane policy
+constexpr int KIND_LANE = ANY_LANE;
+
+struct PatternSpawn {
+    ObstacleKind kind;
+    int lane;
+    // position within the chunk, 0 = near edge, 1 = far edge
+    float offset;
+};
+
+struct ObstaclePattern {
+    float weight;
+    // the whole pattern is shifted by up to this much either way
+    float jitter;
+    int count;
+    PatternSpawn spawns[Chunk::MAX_OBSTACLES];
+};
+
+// Authored arrangements, spawns ordered near to far. ChunkGenerator draws
+// one per chunk by weight; the first four are the single obstacles the game
+// always had, anywhere in the chunk.
+constexpr ObstaclePattern OBSTACLE_PATTERNS[] = {
+    // nothing, a breather
+    {1.0f, 0.0f, 0, {}},
+    {1.0f, 0.5f, 1, {{ObstacleKind::TRUNK, KIND_LANE, 0.5f}}},
+    {1.0f, 0.5f, 1, {{ObstacleKind::DOWN_TRUNK, KIND_LANE, 0.5f}}},
+    {1.0f, 0.5f, 1, {{ObstacleKind::UP_TRUNK, KIND_LANE, 0.5f}}},
+    // gate: only the middle lane is open
+    {0.4f, 0.3f, 2, {{ObstacleKind::TRUNK, 0, 0.5f}, {ObstacleKind::TRUNK, 2, 0.5f}}},
+    // slalom from one side to the other
+    {0.4f, 0.15f, 2, {{ObstacleKind::TRUNK, 0, 0.3f}, {ObstacleKind::TRUNK, 2, 0.7f}}},
+    // under the raised trunk, then straight into the jump over the fallen
+    // one. The other way round never fits a chunk, a jump lands too late
+    {0.3f, 0.0f, 2, {{ObstacleKind::UP_TRUNK, KIND_LANE, 0.0f}, {ObstacleKind::DOWN_TRUNK, KIND_LANE, 1.0f}}},
+};
+
+constexpr int OBSTACLE_PATTERN_COUNT = static_cast<int>(sizeof(OBSTACLE_PATTERNS) / sizeof(OBSTACLE_PATTERNS[0]));
+
+#endif // OBSTACLE_PATTERNS_HPP
@@ -0,0 +1,36 @@
+#ifndef OBSTACLE_STORE_HPP
+#define OBSTACLE_STORE_HPP
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "BoxRing.hpp"
+#include "ObstacleCatalog.hpp"
+
+// The obstacles of the run, one array per field, on a BoxRing: the live
+// slots are ordered by distance and a loop over liveRanges() reads just the
+// columns it needs.
+//
+// The collision box of every obstacle is computed once on push and kept in
+// the ring's box columns, so collision and debug drawing never rebuild it.
+class ObstacleStore : public BoxRing {
+public:
+    explicit ObstacleStore(int capacity);
+
+    // false, and nothing stored, when the store is full
+    bool push(ObstacleKind kind, int lane, const glm::vec3 &position);
+
+    const ObstacleKind *kinds() const;
+    const int *lanes() const;
+    const float *positionX() const;
+    const float *positionZ() const;
+
+private:
+    std::vector<ObstacleKind> kindColumn;
+    std::vector<int> laneColumn;
+    std::vector<float> xColumn;
+    std::vector<float> zColumn;
+};
+
+#endif // OBSTACLE_STORE_HPP
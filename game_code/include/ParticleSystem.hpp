@@ -0,0 +1,78 @@
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Shader.hpp"
+
+enum ParticleKind {
+    PARTICLE_DUST = 0,
+    PARTICLE_SPLINTER = 1
+};
+
+// `count` new particles around `origin`; velocity and life get a random
+// spread per particle on the GPU
+struct ParticleEmission {
+    glm::vec3 origin;
+    float radius;
+    glm::vec3 velocity;
+    glm::vec3 spread;
+    float life;
+    int count;
+    ParticleKind kind;
+};
+
+// Particles that live entirely on the GPU.
+//
+// Two buffers hold the state of every slot (position, age, velocity,
+// lifetime, kind). Each frame a vertex-only program reads one buffer and
+// writes the advanced state into the other with transform feedback, then
+// the buffers swap roles. Emission claims a contiguous range of slots from
+// a ring cursor and the update shader respawns exactly those, so the CPU
+// work per frame depends on the number of emitters, never on the number of
+// particles. The oldest particles are overwritten when the ring wraps.
+class ParticleSystem {
+public:
+    // keep in sync with particle_update.vert
+    static const int MAX_EMITTERS = 8;
+
+    ParticleSystem(int capacity, float groundLevel);
+
+    void update(const std::vector<ParticleEmission> &emissions, float dt);
+    // blended, without depth writes, after the opaque scene
+    void draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition);
+    void release();
+
+    int getCapacity() const;
+
+    glm::vec3 gravity = glm::vec3(0.0f, -2.5f, 0.0f);
+    float drag = 1.5f;
+
+private:
+    struct Particle {
+        glm::vec4 positionAge;
+        glm::vec4 velocityLife;
+        float kind;
+    };
+
+    int capacity;
+    float groundLevel;
+
+    Shader updateShader;
+    Shader drawShader;
+
+    GLuint buffers[2] = {};
+    GLuint updateVAO[2] = {};
+    GLuint drawVAO[2] = {};
+    GLuint quadVBO = 0;
+    // the buffer holding the latest state
+    int current = 0;
+    int cursor = 0;
+    std::uint32_t frame = 0;
+};
+
+#endif // PARTICLE_SYSTEM_HPP
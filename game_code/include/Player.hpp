@@ -4,28 +4,53 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+// The ball. Lane switches, jumps and crouches are curves of time: each
+// action remembers when it started, and the position is evaluated from the
+// start times on the player's clock, so it does not depend on how the time
+// was cut into steps and can be asked for at any future time. A lane switch
+// eases in and out along a cubic, jumps and crouches follow a parabola.
 class Player {
 public:
     Player(const std::vector<float>& lanes, int startLaneIndex, float switchSpeed, float jumpSpeed, float crouchSpeed);
+    // starts the actions pressed, then advances the clock by deltaTime
     void ProcessInput(bool leftKeyPressed, bool rightKeyPressed, bool upKeyPressed, bool downKeyPressed, float deltaTime);
     glm::vec3 GetPosition() const;
+    // where the player is at time on its clock if nothing new is pressed
+    // before then, the forward motion continuing at the last speed
+    glm::vec3 GetPositionAt(float time) const;
+    // the player's clock, seconds of ProcessInput so far
+    float getTime() const;
+    // when every action in progress is over, getTime() when there is none
+    float getRestTime() const;
     int getCurrentLane();
     void MoveForward(float speed, float deltaTime);
 
 private:
+    enum VerticalAction { VERTICAL_NONE, VERTICAL_JUMP, VERTICAL_CROUCH };
+
+    float laneX(float time) const;
+    float height(float time) const;
+    float verticalDuration() const;
+
     std::vector<float> lanes;
     int currentLaneIndex;
-    float laneSwitchSpeed;
+    // lane being switched to, currentLaneIndex when not switching
+    int targetLaneIndex;
     glm::vec3 position;
-    float jumpSpeed;
-    float crouchSpeed;
-    float targetJump = 0.5f;
-    float targetCrouch = -0.3f;
-    bool isJumping = false;
-    bool isGrounding = false;
-    bool isCrouching = false;
-    bool goingLeft = false;
-    bool goingRight = false;
+    float clock = 0.0f;
+    float forwardSpeed = 0.0f;
+
+    float laneSwitchTime;
+    float jumpTime;
+    float crouchTime;
+    float jumpHeight = 0.42f;
+    // the ball's top stays above the bottom of a fallen trunk, a crouch
+    // never gets under one
+    float crouchDepth = 0.18f;
+
+    float laneStart = 0.0f;
+    VerticalAction vertical = VERTICAL_NONE;
+    float verticalStart = 0.0f;
 };
 
 #endif // PLAYER_HPP
@@ -0,0 +1,143 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Refers to one object of a Pool. A handle stays tied to the object it was
+// created for: once that object is destroyed its slot's generation moves
+// on, and the handle no longer resolves, even after the slot is reused.
+struct PoolHandle {
+    std::uint32_t index = INVALID;
+    std::uint32_t generation = 0;
+
+    static const std::uint32_t INVALID = 0xffffffffu;
+
+    bool valid() const { return index != INVALID; }
+};
+
+// Fixed number of objects of one type, all memory taken up front.
+//
+// The objects are kept packed at the front of one array, so iterating the
+// live ones is a plain loop with no holes; destroying one moves the last
+// object into its place. Handles go through a slot table that follows the
+// objects around, and free slots are chained in a list, so create, destroy
+// and lookup are all O(1) and never allocate. Pointers and references into
+// the pool only last until the next destroy, keep handles instead.
+template <typename T> class Pool {
+public:
+    explicit Pool(std::uint32_t capacity) : slots(capacity), freeHead(capacity == 0 ? NONE : 0) {
+        objects.reserve(capacity);
+        owners.reserve(capacity);
+        for (std::uint32_t i = 0; i < capacity; i++) {
+            slots[i].nextFree = i + 1 < capacity ? i + 1 : NONE;
+        }
+    }
+
+    // an invalid handle when the pool is full, nothing is created then
+    template <typename... Args> PoolHandle create(Args &&... args) {
+        PoolHandle handle;
+        if (freeHead == NONE) {
+            failedCreates++;
+            return handle;
+        }
+        std::uint32_t index = freeHead;
+        Slot &slot = slots[index];
+        freeHead = slot.nextFree;
+
+        slot.dense = static_cast<std::uint32_t>(objects.size());
+        objects.emplace_back(std::forward<Args>(args)...);
+        owners.push_back(index);
+        if (objects.size() > highWater) {
+            highWater = static_cast<std::uint32_t>(objects.size());
+        }
+
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    // false for a stale or invalid handle
+    bool destroy(PoolHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Slot &slot = slots[handle.index];
+        std::uint32_t last = static_cast<std::uint32_t>(objects.size()) - 1;
+        if (slot.dense != last) {
+            objects[slot.dense] = std::move(objects[last]);
+            owners[slot.dense] = owners[last];
+            slots[owners[last]].dense = slot.dense;
+        }
+        objects.pop_back();
+        owners.pop_back();
+
+        slot.generation++;
+        slot.dense = NONE;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        return true;
+    }
+
+    bool contains(PoolHandle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].dense != NONE;
+    }
+
+    // nullptr for a stale or invalid handle
+    T *get(PoolHandle handle) { return contains(handle) ? &objects[slots[handle.index].dense] : nullptr; }
+    const T *get(PoolHandle handle) const { return contains(handle) ? &objects[slots[handle.index].dense] : nullptr; }
+
+    // handle of the object at position i of the live objects
+    PoolHandle handleAt(std::uint32_t i) const {
+        PoolHandle handle;
+        handle.index = owners[i];
+        handle.generation = slots[owners[i]].generation;
+        return handle;
+    }
+
+    // the live objects, in no particular order
+    T *begin() { return objects.data(); }
+    T *end() { return objects.data() + objects.size(); }
+    const T *begin() const { return objects.data(); }
+    const T *end() const { return objects.data() + objects.size(); }
+
+    std::uint32_t size() const { return static_cast<std::uint32_t>(objects.size()); }
+    std::uint32_t capacity() const { return static_cast<std::uint32_t>(slots.size()); }
+    bool empty() const { return objects.empty(); }
+    bool full() const { return freeHead == NONE; }
+
+    // most objects ever alive at once, and creates refused because the pool
+    // was full; for sizing the pool
+    std::uint32_t getHighWater() const { return highWater; }
+    std::uint32_t getFailedCreates() const { return failedCreates; }
+
+    void report(const std::string &name) const {
+        std::cout << "POOL::" << name << " live " << size() << '/' << capacity() << " high water " << highWater
+                  << " failed " << failedCreates << std::endl;
+    }
+
+private:
+    static const std::uint32_t NONE = 0xffffffffu;
+
+    struct Slot {
+        std::uint32_t generation = 0;
+        // position in objects while live, NONE while free
+        std::uint32_t dense = NONE;
+        std::uint32_t nextFree = NONE;
+    };
+
+    std::vector<T> objects;
+    // slot of every object in objects
+    std::vector<std::uint32_t> owners;
+    std::vector<Slot> slots;
+    std::uint32_t freeHead;
+
+    std::uint32_t highWater = 0;
+    std::uint32_t failedCreates = 0;
+};
+
+#endif // POOL_HPP
@@ -0,0 +1,39 @@
+#ifndef PROGRAM_BINARY_CACHE_HPP
+#define PROGRAM_BINARY_CACHE_HPP
+
+#include <glad/glad.h>
+
+#include <string>
+
+// Persists linked shader programs on disk through glGetProgramBinary /
+// glProgramBinary (core in 4.1, ARB_get_program_binary before that), so the
+// driver compile and link only happen the first time a shader is seen.
+//
+// One file is kept per shader source: its name is a hash of the sources and
+// its header records the vendor, renderer and driver version that produced
+// it. Editing a shader or updating the driver therefore invalidates the entry
+// automatically, and the next successful link overwrites it.
+class ProgramBinaryCache {
+public:
+  // directory the cache files are written to, created on first store
+  static void setDirectory(const std::string &dir);
+
+  // true when the context exposes at least one program binary format
+  static bool isSupported();
+
+  // Tries to restore `program` from the cache entry for `source`. Returns
+  // false when there is no usable entry or the driver rejected the binary;
+  // the caller then compiles from source on the same program object.
+  static bool load(GLuint program, const std::string &source);
+
+  // Stores the binary of the already linked `program` under `source`.
+  static void store(GLuint program, const std::string &source);
+
+private:
+  static std::string entryPath(const std::string &source);
+  static std::string driverSignature();
+
+  static std::string directory;
+};
+
+#endif // PROGRAM_BINARY_CACHE_HPP
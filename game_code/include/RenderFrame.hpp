@@ -0,0 +1,96 @@
+#ifndef RENDER_FRAME_HPP
+#define RENDER_FRAME_HPP
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "CoinStore.hpp"
+#include "DebugDraw.hpp"
+#include "FrameArena.hpp"
+#include "FramePacer.hpp"
+#include "ParticleSystem.hpp"
+#include "RenderIds.hpp"
+#include "TiledLighting.hpp"
+
+// How the opaque scene draws are ordered. Sorting front to back lets the
+// depth test reject hidden fragments before the fog shader runs on them;
+// the pre-pass additionally lays down depth first so every pixel is shaded
+// exactly once, at the cost of a second, cheap geometry pass.
+enum class OpaqueOrder { SUBMISSION, FRONT_TO_BACK, DEPTH_PREPASS };
+
+// One draw of the 3D scene. TextureId::NONE draws flat in `color`.
+struct DrawCommand {
+    MeshId mesh;
+    TextureId texture;
+    glm::vec3 color;
+    glm::mat4 model;
+};
+
+// One line of HUD text, position in window pixels from the lower left.
+// text is a literal or lives in the frame's arena.
+struct TextCommand {
+    const char *text;
+    glm::vec2 position;
+    float scale;
+    glm::vec3 color;
+};
+
+// Everything the render thread needs to draw one frame. Built by the main
+// thread from the interpolated simulation state and handed over whole, so
+// the renderer never reads the simulation directly.
+struct RenderFrame {
+    // window state, only the main thread may ask GLFW for it
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    SwapMode swapMode = SwapMode::VSYNC;
+    bool lowPower = false;
+    // a screenshot is taken whenever this grows, so a request cannot get
+    // lost in a frame the render thread skipped
+    unsigned int screenshotCount = 0;
+    bool recording = false;
+
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 cameraPosition;
+    // simulated seconds, for animation done on the GPU
+    float time = 0.0f;
+    // draws the scene flat with the end screen shading
+    bool endScreen = false;
+    // debug view: every shaded scene fragment adds to a heat ramp instead
+    // of its color, see overdraw.frag
+    bool overdrawHeatmap = false;
+    bool depthPrepass = false;
+    // text is laid out in a fixed virtual resolution, independent of the window
+    glm::mat4 textProjection;
+
+    std::vector<DrawCommand> draws;
+    std::vector<TextCommand> texts;
+    std::vector<PointLight> lights;
+    // filled through DebugDraw while the frame is recorded
+    std::vector<DebugVertex> debugLines;
+
+    // particle time step and emissions since the last frame the render thread
+    // actually drew; carried over by the main thread when a frame is skipped
+    float particleDt = 0.0f;
+    std::vector<ParticleEmission> particleEmissions;
+    // coin slots changed since the last frame the render thread drew,
+    // carried over the same way
+    std::vector<CoinUpdate> coinUpdates;
+
+    // transient data of this frame only, such as formatted text. Every slot
+    // has its own, so the main thread can reset the one it records into
+    // while the render thread still reads another.
+    FrameArena arena{16 * 1024, "render frame"};
+
+    // empties the command lists but keeps their storage, so a frame slot
+    // stops allocating after the first few frames; debugLines is managed
+    // by DebugDraw::begin
+    void clear() {
+        draws.clear();
+        texts.clear();
+        lights.clear();
+    }
+};
+
+#endif // RENDER_FRAME_HPP
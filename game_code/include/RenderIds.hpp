@@ -0,0 +1,9 @@
+#ifndef RENDER_IDS_HPP
+#define RENDER_IDS_HPP
+
+// Geometry and textures the renderer creates at start-up. Commands refer to
+// them by id because the GL names only exist on the render thread.
+enum class MeshId { PATH_SEGMENT, WALL_SEGMENT, TRUNK_TOP, TRUNK_SIDE, DOWN_TRUNK, UP_TRUNK, BALL, END_SCREEN, COUNT };
+enum class TextureId { NONE, PATH, WALL, TRUNK, CIRCLE_TRUNK, FALLEN_TRUNK, BALL, COUNT };
+
+#endif // RENDER_IDS_HPP
@@ -0,0 +1,96 @@
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <map>
+#include <string>
+
+#include "CoinRenderer.hpp"
+#include "DebugDraw.hpp"
+#include "DynamicResolution.hpp"
+#include "FrameCapture.hpp"
+#include "FramePacer.hpp"
+#include "MeshBuilder.hpp"
+#include "ParticleSystem.hpp"
+#include "RenderFrame.hpp"
+#include "Shader.hpp"
+#include "TiledLighting.hpp"
+
+struct GLFWwindow;
+
+struct Character {
+    unsigned int TextureID; // ID handle of the glyph texture
+    glm::ivec2   Size;      // Size of glyph
+    glm::ivec2   Bearing;   // Offset from baseline to left/top of glyph
+    unsigned int Advance;   // Horizontal offset to advance to next glyph
+};
+
+// Owns every GL resource of the game and turns RenderFrames into GL calls.
+// Everything in here, the constructor included, must run on the thread the
+// GL context is current on.
+class Renderer {
+public:
+    Renderer(float groundLevel, float segmentLength, int coinCapacity, int framebufferWidth,
+             int framebufferHeight, SwapMode swapMode, double frameCap);
+
+    // false when a resource failed to load, the game cannot run then
+    bool isReady() const;
+
+    void render(const RenderFrame &frame);
+    // paces and swaps, call after render()
+    void present(GLFWwindow *window, const RenderFrame &frame);
+    void release();
+
+private:
+    bool loadFont(const char *path);
+    void buildMeshes(float groundLevel, float segmentLength);
+    void drawScene(const RenderFrame &frame);
+    // materials = false only sets the model matrix, for the depth and
+    // overdraw passes
+    void drawCommands(const RenderFrame &frame, Shader &shader, bool materials);
+    void readOverdrawQuery();
+    void renderText(const TextCommand &text);
+
+    bool ready = true;
+
+    Shader sceneShader;
+    Shader textShader;
+    Shader overdrawShader;
+
+    Mesh pathMesh, wallMesh, ballMesh, obstacleMesh, quadMesh;
+    const Mesh *meshes[static_cast<int>(MeshId::COUNT)];
+    SubMesh subMeshes[static_cast<int>(MeshId::COUNT)];
+    GLuint textures[static_cast<int>(TextureId::COUNT)] = {};
+
+    std::map<GLchar, Character> characters;
+    GLuint textVAO = 0;
+    GLuint textVBO = 0;
+
+    // GL_SAMPLES_PASSED around the heatmap pass gives shaded fragments per
+    // scene pixel, reported every overdrawReportInterval results
+    GLuint overdrawQuery = 0;
+    bool overdrawQueryPending = false;
+    double overdrawQueryPixels = 0.0;
+    double overdrawSum = 0.0;
+    int overdrawResults = 0;
+    static const int overdrawReportInterval = 60;
+
+    TiledLighting lighting;
+    ParticleSystem particles;
+    CoinRenderer coins;
+    DebugDrawRenderer debugDraw;
+    DynamicResolution dynamicResolution;
+    FramePacer framePacer;
+    SwapMode appliedSwapMode;
+    FrameCapture frameCapture;
+    unsigned int screenshotCount = 0;
+
+    // GLState issued / skipped counters are printed every
+    // stateReportInterval presented frames
+    int stateReportFrames = 0;
+    static const int stateReportInterval = 600;
+};
+
+#endif // RENDERER_HPP
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 class Shader {
 public:
@@ -24,6 +25,12 @@ public:
   // ------------------------------------------------------------------------
   Shader(const std::string vertexPath, const std::string fragmentPath);
 
+  // vertex-only program whose outputs are captured with transform feedback,
+  // interleaved into one buffer in the given order
+  // ------------------------------------------------------------------------
+  Shader(const std::string vertexPath,
+         const std::vector<std::string> &feedbackVaryings);
+
   // activate the shader
   // ------------------------------------------------------------------------
   void use();
@@ -62,9 +69,10 @@ public:
   void setMat4(const std::string &name, const glm::mat4 &mat) const;
 
 private:
-  // utility function for checking shader compilation/linking errors.
+  // utility function for checking shader compilation/linking errors,
+  // returns true when the shader compiled / the program linked
   // ------------------------------------------------------------------------
-  void checkCompileErrors(unsigned int shader, std::string type);
+  bool checkCompileErrors(unsigned int shader, std::string type);
 
   void readShader(char const *const, Shader::SHADER_TYPE);
 
@@ -72,6 +80,7 @@ private:
 
   std::string vertexShader;
   std::string fragmentShader;
+  std::vector<std::string> feedbackVaryings;
 };
 
 #endif // SHADER_HPP
@@ -0,0 +1,105 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Camera.hpp"
+#include "ChunkGenerator.hpp"
+#include "CoinStore.hpp"
+#include "ObstacleStore.hpp"
+#include "Player.hpp"
+#include "SpatialGrid.hpp"
+
+struct PlayerInput {
+    bool left;
+    bool right;
+    bool up;
+    bool down;
+};
+
+// The part of the simulation state that moves continuously and therefore
+// gets interpolated between two steps when drawing
+struct SimulationSnapshot {
+    glm::vec3 playerPosition;
+    glm::vec3 cameraPosition;
+    float playerRotationAngle;
+};
+
+// Game state advanced in fixed steps: player and camera movement, segment
+// recycling, obstacle and coin spawning, collision detection and coin
+// collection. Nothing in here
+// touches OpenGL, the renderer only reads the public state.
+class Simulation {
+public:
+    Simulation(const std::vector<float> &lanes, float laneSwitchSpeed, float jumpSpeed, float crouchSpeed,
+               float groundLevel, float startZ, float length, int numSegments, int obstacleCapacity,
+               int coinCapacity, float stepSize, std::uint64_t seed);
+
+    void step(const PlayerInput &input, float dt);
+    // 0 = state before the last step, 1 = state after it
+    SimulationSnapshot interpolate(float alpha) const;
+
+    std::vector<float> lanes;
+    float groundLevel;
+
+    Camera camera;
+    Player player;
+    float playerRotationAngle = 0.0f;
+
+    //path segments, segmentZ is the near edge of every segment
+    int numSegments;
+    float segmentLength;
+    std::vector<float> segmentZ;
+
+    ObstacleStore obstacles;
+    // obstacle slots by lane and depth, kept in sync with the store
+    SpatialGrid obstacleGrid;
+
+    CoinStore coins;
+    int coinsCollected = 0;
+    // coin slots that changed since the main thread last took them, the
+    // renderer applies them to its copy of the coins
+    std::vector<CoinUpdate> coinUpdates;
+
+    // simulated seconds since the start of the run
+    float time = 0.0f;
+    bool gameOver = false;
+    float collisionTime = 0.0f;
+    // center of the overlap between the player and the obstacle it hit
+    glm::vec3 collisionPoint = glm::vec3(0.0f);
+
+private:
+    SimulationSnapshot snapshot() const;
+    // sweeps the player box from startPosition to its current position
+    void detectCollisions(const glm::vec3 &startPosition, float dt);
+    // collects every coin the player box swept through
+    void collectCoins(const glm::vec3 &startPosition);
+    void recycleSegment();
+    // places every ready chunk that starts before farZ
+    void spawnChunks(float farZ);
+
+    float forwardSpeed = 2.5f;
+    float rotationSpeed = 90.0f;
+
+    SimulationSnapshot previous;
+
+    float playerStartPos;
+    unsigned int pointer = 0;
+    float endZ;
+    // z where the run, and chunk distances, start
+    float startZ;
+    // declared after the player speeds, the generator's checker needs them
+    ChunkGenerator chunks;
+    // where the chunks placed or dropped so far end
+    float chunkEnd;
+
+    // obstacle slots the last sweep had to test, reused every step
+    std::vector<int> sweepCandidates;
+    // coins the last sweep touched, reused every step
+    std::vector<std::uint64_t> coinHits;
+};
+
+#endif // SIMULATION_HPP
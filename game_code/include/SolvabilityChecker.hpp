@@ -0,0 +1,84 @@
+#ifndef SOLVABILITY_CHECKER_HPP
+#define SOLVABILITY_CHECKER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Chunk.hpp"
+
+// Decides whether a chunk can be passed, by tracking every state the player
+// could be in along the run.
+//
+// A state is a lane together with a phase of the vertical action (standing,
+// jumping, crouching), or a phase of a switch between two lanes. The
+// movement of each action is sampled once from the curves of a real
+// Player, so the checker follows the Player code and its speeds rather
+// than a copy of them. The chunk is cut into steps of equal length; per
+// step the reachable states are a bitset, advanced through the possible
+// successors and masked with the states whose box, swept over the step,
+// hits an obstacle. The chunk is passable when some state survives to its
+// end.
+//
+// The model is stricter than the game: a lane switch only starts from the
+// ground and cannot be combined with a jump or crouch. So anything it
+// accepts is passable, while it may reject a few tight but passable chunks.
+class SolvabilityChecker {
+public:
+    typedef std::vector<std::uint64_t> StateSet;
+
+    // stepSize is the simulation step the Player is advanced with
+    SolvabilityChecker(const std::vector<float> &lanes, float laneSwitchSpeed, float jumpSpeed, float crouchSpeed,
+                       float groundLevel, float forwardSpeed, float stepSize, float chunkLength);
+
+    // standing in any lane, the state at the start of the run
+    StateSet groundStates() const;
+
+    // advances reach over the chunk starting at startDistance. obstacles
+    // must also list those of the previous chunk that reach into this one.
+    // Returns false, and leaves reach alone, when no state survives.
+    //
+    // Reach trails the chunk by lagSteps: the last steps of a chunk are
+    // checked with the next one, so an obstacle that reaches back across
+    // the boundary still blocks them.
+    bool advance(float startDistance, const ObstacleSpawn *obstacles, int count, StateSet &reach);
+
+    int getStateCount() const;
+    int getStepsPerChunk() const;
+    // the standing player's box, bottom and top above the obstacles' ground
+    float getStandingBottom() const;
+    float getStandingTop() const;
+    // how far the player's center rises at the top of a jump
+    float getJumpHeight() const;
+
+private:
+    // lateral and vertical extent of the player center over one step
+    struct StateRange {
+        float minX, maxX;
+        float minY, maxY;
+    };
+
+    void addState(float minX, float maxX, float minY, float maxY);
+    void markBlocked(float nearDistance, float farDistance, const ObstacleSpawn *obstacles, int count);
+
+    std::vector<float> lanes;
+    float groundLevel;
+    int stepsPerChunk;
+    float stepLength;
+    // steps the player box and the deepest obstacle box span together
+    int lagSteps;
+    // half size of the player box
+    float halfWidth, halfHeight, halfDepth;
+    float standingBottom, standingTop;
+    float jumpHeight;
+
+    // lane states come first, verticalCount of them per lane
+    int verticalCount;
+    std::vector<StateRange> states;
+    std::vector<std::vector<int> > successors;
+    int wordCount = 0;
+
+    // scratch, kept so checking never allocates
+    StateSet current, next, blocked;
+};
+
+#endif // SOLVABILITY_CHECKER_HPP
@@ -0,0 +1,70 @@
+#ifndef SPATIAL_GRID_HPP
+#define SPATIAL_GRID_HPP
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Boxes binned by lane and by depth, for queries that should only touch
+// what is near the player.
+//
+// Columns are the lanes, split halfway between lane centers (the outer
+// lanes reach out to infinity). Rows are bucketDepth long slices of z,
+// kept in a ring of bucketCount rows, so the grid follows the run without
+// ever being rebuilt. A box is listed in every cell it overlaps; a fallen
+// trunk across the path lands in all lanes of its row.
+//
+// Ids are small integers below the capacity, e.g. ObstacleStore slots.
+// Inserting and removing is incremental. Queries return each id once, and
+// only ids whose box really satisfies the query, so two z values sharing a
+// ring row never produce false hits.
+class SpatialGrid {
+public:
+    SpatialGrid(const std::vector<float> &laneCenters, float bucketDepth, int bucketCount, int capacity);
+
+    void insert(int id, const glm::vec3 &min, const glm::vec3 &max);
+    void remove(int id);
+    void clear();
+
+    // ids whose box overlaps [min, max], appended to out
+    void queryBox(const glm::vec3 &min, const glm::vec3 &max, std::vector<int> &out);
+    // ids whose box is within radius of center
+    void queryRadius(const glm::vec3 &center, float radius, std::vector<int> &out);
+    // ids in the lane (any lane when lane < 0) with a box reaching into the
+    // z interval between z0 and z1, in either order
+    void queryRange(int lane, float z0, float z1, std::vector<int> &out);
+
+    int getLaneCount() const;
+
+private:
+    // moves stamp up to its wrap-around, which would otherwise take four
+    // billion queries
+    friend class SpatialGridTest;
+
+    struct Item {
+        glm::vec3 min;
+        glm::vec3 max;
+        int firstLane, lastLane;
+        int firstBucket, lastBucket;
+        bool live;
+    };
+
+    int laneOf(float x) const;
+    int bucketOf(float z) const;
+    std::vector<int> &cell(int lane, int bucket);
+    // appends the ids listed in the cells, each once
+    void gather(int firstLane, int lastLane, int firstBucket, int lastBucket, std::vector<int> &out);
+
+    // x where one lane ends and the next begins
+    std::vector<float> laneEdges;
+    float bucketDepth;
+    int bucketCount;
+
+    std::vector<std::vector<int> > cells;
+    std::vector<Item> items;
+    // ids already gathered by the current query carry its stamp
+    std::vector<unsigned int> stamps;
+    unsigned int stamp = 0;
+};
+
+#endif // SPATIAL_GRID_HPP
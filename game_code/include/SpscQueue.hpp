@@ -0,0 +1,60 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded queue from exactly one producer thread to exactly one consumer
+// thread.
+//
+// The producer only writes tail and the consumer only writes head, so both
+// ends are a plain store after an acquire load of the other side's index;
+// nobody ever locks or waits. One slot stays unused to tell full from empty.
+template <typename T> class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity) : slots(capacity + 1), head(0), tail(0) {}
+
+    // producer: false when full, nothing is stored then
+    bool push(const T &value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        std::size_t next = advance(t);
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[t] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: the oldest element, nullptr when empty. Stays valid until
+    // pop().
+    const T *front() const {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[h];
+    }
+
+    // consumer: drops the element returned by front()
+    void pop() {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h != tail.load(std::memory_order_acquire)) {
+            head.store(advance(h), std::memory_order_release);
+        }
+    }
+
+    // either side, only a snapshot while the other side is running
+    bool full() const { return advance(tail.load(std::memory_order_acquire)) == head.load(std::memory_order_acquire); }
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+private:
+    std::size_t advance(std::size_t index) const { return index + 1 == slots.size() ? 0 : index + 1; }
+
+    std::vector<T> slots;
+    std::atomic<std::size_t> head;
+    std::atomic<std::size_t> tail;
+};
+
+#endif // SPSC_QUEUE_HPP
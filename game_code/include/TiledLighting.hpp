@@ -0,0 +1,60 @@
+#ifndef TILED_LIGHTING_HPP
+#define TILED_LIGHTING_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+#include "Shader.hpp"
+
+struct PointLight {
+    glm::vec3 position;
+    float radius; // no contribution beyond this distance
+    glm::vec3 color;
+    float intensity;
+};
+
+// Forward+ light culling done on the CPU.
+//
+// The viewport is split into TILE_SIZE pixel tiles. Every frame each light's
+// sphere is projected to a screen rectangle and the light is appended to the
+// list of every tile it touches. The lists are flattened into one index
+// array and uploaded, together with the light data and an (offset, count)
+// pair per tile, into texture buffers. shader.frag then loops only over the
+// lights of its own tile, so shading cost follows the lights per tile rather
+// than the total number of lights.
+class TiledLighting {
+public:
+    static const int TILE_SIZE = 16;
+    // texture units used by the three buffers, unit 0 is the diffuse texture
+    static const int FIRST_TEXTURE_UNIT = 1;
+
+    TiledLighting();
+
+    // bins and uploads, width and height are the pixels of the scene viewport
+    void update(const std::vector<PointLight> &lights, const glm::mat4 &view, const glm::mat4 &projection,
+                int width, int height);
+    // binds the buffers and sets the tile uniforms
+    void bind(Shader &shader) const;
+    void release();
+
+private:
+    // screen rectangle of the light's sphere in tiles, false when off screen
+    bool tileRange(const PointLight &light, const glm::mat4 &view, const glm::mat4 &projection,
+                   glm::ivec4 &range) const;
+
+    int tilesX = 0;
+    int tilesY = 0;
+
+    GLuint buffers[3] = {};
+    GLuint textures[3] = {};
+
+    // kept between frames so binning does not allocate
+    std::vector<glm::vec4> lightData;
+    std::vector<GLuint> tileData;
+    std::vector<GLuint> indices;
+    std::vector<glm::ivec4> ranges;
+};
+
+#endif // TILED_LIGHTING_HPP
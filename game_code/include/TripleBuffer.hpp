@@ -0,0 +1,89 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Hands whole frames from one producer thread to one consumer thread.
+//
+// Three slots rotate between the roles back (being written), middle (last
+// published) and front (being read). Publishing and acquiring are a single
+// atomic exchange on the middle index, so neither side ever waits for the
+// other to finish with its slot. The wait functions are only there so idle
+// threads can sleep instead of spinning; they are not needed for correctness.
+template <typename T> class TripleBuffer {
+public:
+    // producer: the slot to fill for the next frame
+    T &back() { return slots[backIndex]; }
+
+    // producer: makes back() the newest frame and takes over the old middle
+    // slot. Returns true when that slot was never acquired; back() then still
+    // holds the skipped frame, so anything that must not be lost can be
+    // carried over into the next one.
+    bool publish() {
+        // the frame's sequence number travels with its slot, so the consumer
+        // knows exactly which publish it took
+        std::uint64_t sequence = published.load(std::memory_order_relaxed) + 1;
+        std::uint64_t previous =
+                middle.exchange((sequence << SEQUENCE_SHIFT) | FRESH_BIT | backIndex, std::memory_order_acq_rel);
+        backIndex = static_cast<std::uint32_t>(previous & INDEX_MASK);
+        published.store(sequence, std::memory_order_release);
+        signal.notify_all();
+        return (previous & FRESH_BIT) != 0;
+    }
+
+    // consumer: swaps in the newest frame, false when nothing new was published
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT)) {
+            return false;
+        }
+        std::uint64_t taken = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = static_cast<std::uint32_t>(taken & INDEX_MASK);
+        // a frame published after the exchange is still waiting in middle,
+        // it must not count as consumed
+        consumed.store(taken >> SEQUENCE_SHIFT, std::memory_order_release);
+        signal.notify_all();
+        return true;
+    }
+
+    // consumer: the frame swapped in by the last successful acquire()
+    const T &front() const { return slots[frontIndex]; }
+
+    // consumer: sleeps until a frame is published or the timeout passes
+    void waitForPublish(std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(signalMutex);
+        signal.wait_for(lock, timeout, [this] { return (middle.load() & FRESH_BIT) != 0; });
+    }
+
+    // producer: sleeps until the consumer picked up everything published so
+    // far, which keeps the producer at most one frame ahead
+    void waitForConsumer(std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(signalMutex);
+        signal.wait_for(lock, timeout, [this] { return consumed.load() == published.load(); });
+    }
+
+private:
+    // middle holds the slot index, the fresh bit and, above them, the
+    // sequence number of the frame in the slot
+    static const std::uint64_t FRESH_BIT = 4;
+    static const std::uint64_t INDEX_MASK = 3;
+    static const int SEQUENCE_SHIFT = 3;
+
+    T slots[3];
+    std::uint32_t backIndex = 0;
+    std::atomic<std::uint64_t> middle{1};
+    std::uint32_t frontIndex = 2;
+
+    // sequence number of the last frame published, and of the last one
+    // acquired
+    std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> consumed{0};
+
+    std::mutex signalMutex;
+    std::condition_variable signal;
+};
+
+#endif // TRIPLE_BUFFER_HPP
@@ -0,0 +1,59 @@
+#ifndef VERTEX_FORMAT_HPP
+#define VERTEX_FORMAT_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Attribute locations shared by every shader that draws scene meshes
+enum VertexAttributeLocation {
+    ATTRIB_POSITION = 0,
+    ATTRIB_TEXCOORD = 1,
+    ATTRIB_NORMAL = 2
+};
+
+struct VertexAttribute {
+    GLuint location;
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    std::size_t offset;
+};
+
+// Describes how one interleaved vertex is laid out in a buffer, so the
+// glVertexAttribPointer calls are written once per format instead of once
+// per mesh.
+class VertexFormat {
+public:
+    explicit VertexFormat(GLsizei stride);
+    VertexFormat &add(GLuint location, GLint components, GLenum type, GLboolean normalized, std::size_t offset);
+    // points the attributes of the bound VAO at the bound GL_ARRAY_BUFFER
+    void apply() const;
+    GLsizei getStride() const;
+
+private:
+    GLsizei stride;
+    std::vector<VertexAttribute> attributes;
+};
+
+// Texture coordinates are stored as normalized 16-bit values covering
+// [0, TEXCOORD_RANGE) and scaled back in shader.vert; the walls and fallen
+// trunks repeat their textures up to 5 times.
+const float TEXCOORD_RANGE = 8.0f;
+
+// 16 bytes per vertex: half-float position, unorm16 UV and a 10:10:10:2
+// normal. The same data as floats would take 32 bytes.
+struct PackedVertex {
+    GLhalf position[3];
+    GLhalf padding; // keeps the texture coordinates 4-byte aligned
+    GLushort texCoord[2];
+    GLuint normal;
+};
+
+PackedVertex packVertex(const glm::vec3 &position, const glm::vec2 &texCoord, const glm::vec3 &normal);
+
+const VertexFormat &packedVertexFormat();
+
+#endif // VERTEX_FORMAT_HPP
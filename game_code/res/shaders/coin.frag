@@ -0,0 +1,32 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+uniform vec3 fogColor;
+uniform float fogStart;
+uniform float fogEnd;
+uniform vec3 cameraPos;
+
+const vec3 COIN_COLOR = vec3(1.0, 0.78, 0.2);
+const vec3 LIGHT_DIRECTION = vec3(0.3, 0.8, 0.5);
+
+void main()
+{
+        // drawn double-sided, light the side facing the camera
+        vec3 normal = normalize(Normal);
+        vec3 toCamera = normalize(cameraPos - FragPos);
+        if (dot(normal, toCamera) < 0.0)
+                normal = -normal;
+
+        vec3 light = normalize(LIGHT_DIRECTION);
+        float diffuse = max(dot(normal, light), 0.0);
+        float specular = pow(max(dot(reflect(-light, normal), toCamera), 0.0), 24.0);
+        vec3 color = COIN_COLOR * (0.45 + 0.55 * diffuse) + vec3(0.5) * specular;
+
+        float distance = length(FragPos - cameraPos);
+        float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
+
+        FragColor = vec4(mix(fogColor, color, fogFactor), 1.0);
+}
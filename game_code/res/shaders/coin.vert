@@ -0,0 +1,41 @@
+#version 330 core
+// one coin per instance, every slot of the CoinStore is drawn
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec3 aNormal;
+layout (location = 3) in vec4 positionVisible;
+
+out vec3 FragPos;
+out vec3 Normal;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float time;
+
+// radians per second, about half a turn; neighbouring coins are out of
+// phase by their depth, SPIN_PHASE radians per unit
+const float SPIN_SPEED = 3.0;
+const float SPIN_PHASE = 2.5;
+
+void main()
+{
+        if (positionVisible.w < 0.5) {
+                // collected or empty slot, put the whole coin outside the clip volume
+                gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+                FragPos = vec3(0.0);
+                Normal = vec3(0.0, 0.0, 1.0);
+                return;
+        }
+
+        float angle = time * SPIN_SPEED + positionVisible.z * SPIN_PHASE;
+        float c = cos(angle);
+        float s = sin(angle);
+        mat3 spin = mat3(c, 0.0, -s,
+                         0.0, 1.0, 0.0,
+                         s, 0.0, c);
+
+        vec3 world = positionVisible.xyz + spin * aPos;
+        gl_Position = projection * view * vec4(world, 1.0);
+        FragPos = world;
+        Normal = spin * aNormal;
+}
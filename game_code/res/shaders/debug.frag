@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 Color;
+
+void main()
+{
+        FragColor = Color;
+}
@@ -0,0 +1,10 @@
+#version 330 core
+out vec4 FragColor;
+
+// Added once per shaded fragment with additive blending. The channels
+// saturate one after another, so the result reads as a heat ramp:
+// 1 layer dark red, 8 layers orange, 16 yellow, 32 and more white.
+void main()
+{
+        FragColor = vec4(0.125, 0.0625, 0.03125, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Corner;
+in vec4 Color;
+in vec3 FragPos;
+
+uniform vec3 fogColor;
+uniform float fogStart;
+uniform float fogEnd;
+uniform vec3 cameraPos;
+
+void main()
+{
+        // round, soft-edged sprite
+        float falloff = 1.0 - dot(Corner, Corner);
+        if (falloff <= 0.0)
+                discard;
+
+        float distance = length(FragPos - cameraPos);
+        float fogFactor = clamp((fogEnd - distance) / (fogEnd - fogStart), 0.0, 1.0);
+
+        FragColor = vec4(mix(fogColor, Color.rgb, fogFactor), Color.a * falloff);
+}
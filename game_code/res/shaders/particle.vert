@@ -0,0 +1,46 @@
+#version 330 core
+// one camera-facing quad per particle, drawn instanced
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec4 positionAge;
+layout (location = 2) in vec4 velocityLife;
+layout (location = 3) in float kind;
+
+out vec2 Corner;
+out vec4 Color;
+out vec3 FragPos;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+        float t = positionAge.w / max(velocityLife.w, 0.0001);
+        if (t >= 1.0) {
+                // dead, put all four corners outside the clip volume
+                gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+                Corner = aCorner;
+                Color = vec4(0.0);
+                FragPos = vec3(0.0);
+                return;
+        }
+
+        // 0 = dust, grows and fades; 1 = impact splinter, shrinks
+        float size;
+        vec4 color;
+        if (kind < 0.5) {
+                size = mix(0.015, 0.05, t);
+                color = vec4(0.55, 0.47, 0.36, 0.35 * (1.0 - t));
+        } else {
+                size = mix(0.025, 0.01, t);
+                color = vec4(0.42, 0.28, 0.14, 1.0 - t * t);
+        }
+
+        vec3 right = vec3(view[0][0], view[1][0], view[2][0]);
+        vec3 up = vec3(view[0][1], view[1][1], view[2][1]);
+        vec3 world = positionAge.xyz + (right * aCorner.x + up * aCorner.y) * size;
+
+        gl_Position = projection * view * vec4(world, 1.0);
+        Corner = aCorner;
+        Color = color;
+        FragPos = world;
+}
@@ -0,0 +1,81 @@
+#version 330 core
+// One invocation per particle slot, the result is captured with transform
+// feedback into the other buffer of the ping-pong pair. Nothing is drawn.
+layout (location = 0) in vec4 positionAge;
+layout (location = 1) in vec4 velocityLife;
+layout (location = 2) in float kind;
+
+out vec4 outPositionAge;
+out vec4 outVelocityLife;
+out float outKind;
+
+// keep in sync with ParticleSystem::MAX_EMITTERS
+const int MAX_EMITTERS = 8;
+
+// every emitter respawns a contiguous range of slots this frame
+uniform int emitterCount;
+uniform int emitStart[MAX_EMITTERS];
+uniform int emitCount[MAX_EMITTERS];
+uniform vec3 emitOrigin[MAX_EMITTERS];
+uniform vec3 emitVelocity[MAX_EMITTERS];
+uniform vec3 emitSpread[MAX_EMITTERS];
+uniform float emitRadius[MAX_EMITTERS];
+uniform float emitLife[MAX_EMITTERS];
+uniform float emitKind[MAX_EMITTERS];
+uniform uint seed;
+
+uniform float dt;
+uniform float groundLevel;
+uniform vec3 gravity;
+uniform float drag;
+
+uint hash(uint x)
+{
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        return x;
+}
+
+// uniform in [-1, 1)
+float random(inout uint state)
+{
+        state = hash(state);
+        return float(state >> 8) / 8388608.0 - 1.0;
+}
+
+void main()
+{
+        for (int i = 0; i < emitterCount; i++) {
+                if (gl_VertexID >= emitStart[i] && gl_VertexID < emitStart[i] + emitCount[i]) {
+                        uint state = hash(uint(gl_VertexID) ^ seed);
+                        vec3 offset = vec3(random(state), random(state), random(state));
+                        vec3 jitter = vec3(random(state), random(state), random(state));
+                        outPositionAge = vec4(emitOrigin[i] + offset * emitRadius[i], 0.0);
+                        outVelocityLife = vec4(emitVelocity[i] + jitter * emitSpread[i],
+                                               emitLife[i] * (0.75 + 0.25 * random(state)));
+                        outKind = emitKind[i];
+                        return;
+                }
+        }
+
+        vec3 position = positionAge.xyz;
+        vec3 velocity = velocityLife.xyz;
+        float age = positionAge.w + dt;
+        if (age < velocityLife.w) {
+                velocity += gravity * dt;
+                velocity *= max(1.0 - drag * dt, 0.0);
+                position += velocity * dt;
+                if (position.y < groundLevel) {
+                        // settle on the path instead of falling through it
+                        position.y = groundLevel;
+                        velocity.y *= -0.3;
+                        velocity.xz *= 0.7;
+                }
+        }
+        outPositionAge = vec4(position, age);
+        outVelocityLife = vec4(velocity, velocityLife.w);
+        outKind = kind;
+}
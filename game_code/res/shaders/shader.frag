@@ -3,6 +3,7 @@ out vec4 FragColor;
 
 in vec3 FragPos;
 in vec2 TexCoord;
+in vec3 Normal;
 
 // texture samplers
 uniform vec3 MyColor;
@@ -17,6 +18,40 @@ uniform float fogStart;
 uniform float fogEnd;
 uniform vec3 cameraPos;
 
+// forward+ lighting, see TiledLighting.hpp: two texels per light
+// (position + radius, color + intensity), an (offset, count) pair per
+// screen tile and the flattened per-tile light indices
+uniform samplerBuffer lightData;
+uniform usamplerBuffer tileLights;
+uniform usamplerBuffer lightIndices;
+uniform int tileSize;
+uniform int tilesX;
+uniform vec3 ambientLight;
+
+vec3 tileLighting(vec3 normal)
+{
+        vec3 lighting = ambientLight;
+        ivec2 tile = ivec2(gl_FragCoord.xy) / tileSize;
+        uvec2 list = texelFetch(tileLights, tile.y * tilesX + tile.x).xy;
+        for (uint i = 0u; i < list.y; i++) {
+                int light = int(texelFetch(lightIndices, int(list.x + i)).r);
+                vec4 positionRadius = texelFetch(lightData, 2 * light);
+                vec4 colorIntensity = texelFetch(lightData, 2 * light + 1);
+
+                vec3 toLight = positionRadius.xyz - FragPos;
+                float distanceSquared = dot(toLight, toLight);
+                float radiusSquared = positionRadius.w * positionRadius.w;
+                if (distanceSquared < radiusSquared) {
+                        // smooth falloff that reaches exactly zero at the radius
+                        float falloff = 1.0 - distanceSquared / radiusSquared;
+                        falloff *= falloff;
+                        float lambert = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-6))), 0.0);
+                        lighting += colorIntensity.rgb * colorIntensity.a * falloff * lambert;
+                }
+        }
+        return lighting;
+}
+
 void main()
 {
         if(!endGame) {
@@ -30,6 +65,11 @@ void main()
                 } else {
                         texColor = vec4(MyColor, 1.0f);
                 }
+                // the scene draws double-sided, light the side facing the camera
+                vec3 normal = normalize(Normal);
+                if (dot(normal, cameraPos - FragPos) < 0.0)
+                        normal = -normal;
+                texColor.rgb *= tileLighting(normal);
 
                 float distance = length(FragPos - cameraPos);
 
@@ -1,17 +1,26 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec3 aNormal;
 
 out vec2 TexCoord;
 out vec3 FragPos;
+out vec3 Normal;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// texture coordinates arrive as unorm16, keep in sync with VertexFormat.hpp
+const float TEXCOORD_RANGE = 8.0;
+
+// must match overdraw.vert bit for bit, the depth pre-pass relies on it
+invariant gl_Position;
+
 void main()
 {
         gl_Position = projection * view * model * vec4(aPos, 1.0);
-        TexCoord = vec2(aTexCoord.x, aTexCoord.y);
+        TexCoord = aTexCoord * TEXCOORD_RANGE;
         FragPos = vec3(model * vec4(aPos, 1.0));
+        Normal = mat3(model) * aNormal;
 }
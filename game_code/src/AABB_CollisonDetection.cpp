@@ -14,26 +14,10 @@ void CollisionDetector::getPlayer(const Player &player, float groundLevel) {
     max = position + glm::vec3(playerWidth / 2, playerHeight/2, playerDepth / 2);
 }
 
-void CollisionDetector::getObstacle(const glm::vec3 &position, int obsType) {
-    if(obsType == 0) {
-        float obstacleWidth = 0.2f;
-        float obstacleHeight = 0.3f;
-        float obstacleDepth = 0.202f;
-        min = position + glm::vec3(-obstacleWidth / 2, 0.0f, -obstacleDepth / 2);
-        max = position + glm::vec3(obstacleWidth / 2, obstacleHeight, obstacleDepth / 2);
-    } else if(obsType == 1) {
-        float obstacleWidth = 12.0f;
-        float obstacleHeight = 0.2f;
-        float obstacleDepth = 0.202f;
-        min = position + glm::vec3(-obstacleWidth / 2, 0.0f, -obstacleDepth / 2);
-        max = position + glm::vec3(obstacleWidth / 2, obstacleHeight, obstacleDepth / 2);
-    } else if (obsType == 2){
-        float obstacleWidth = 14.0f;
-        float obstacleHeight = 0.5f;
-        float obstacleDepth = 0.202f;
-        min = position + glm::vec3(-obstacleWidth / 2, 0.3, -obstacleDepth / 2);
-        max = position + glm::vec3(obstacleWidth / 2, obstacleHeight, obstacleDepth / 2);
-    }
+void CollisionDetector::getObstacle(const glm::vec3 &position, ObstacleKind kind) {
+    const ObstacleTraits &traits = obstacleTraits(kind);
+    min = position + glm::vec3(traits.boxMin[0], traits.boxMin[1], traits.boxMin[2]);
+    max = position + glm::vec3(traits.boxMax[0], traits.boxMax[1], traits.boxMax[2]);
 }
 
 bool CollisionDetector::check(const CollisionDetector &b) {
@@ -42,6 +26,30 @@ bool CollisionDetector::check(const CollisionDetector &b) {
            (min.z <= b.getMax().z && max.z >= b.getMin().z);
 }
 
+// slab test of the segment traced by the minimum corner against b grown by
+// this box's size
+bool CollisionDetector::sweep(const glm::vec3 &displacement, const CollisionDetector &b, float &toi) const {
+    float enter = 0.0f;
+    float exit = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (displacement[axis] == 0.0f) {
+            if (min[axis] > b.max[axis] || max[axis] < b.min[axis]) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (b.min[axis] - max[axis]) / displacement[axis];
+        float t2 = (b.max[axis] - min[axis]) / displacement[axis];
+        enter = glm::max(enter, glm::min(t1, t2));
+        exit = glm::min(exit, glm::max(t1, t2));
+        if (enter > exit) {
+            return false;
+        }
+    }
+    toi = enter;
+    return true;
+}
+
 const glm::vec3 &CollisionDetector::getMin() const {
     return min;
 }
@@ -0,0 +1,93 @@
+#include "AabbBatch.hpp"
+
+// AABB_BATCH_SCALAR forces the one-by-one path, the tests build it that way
+#if defined(AABB_BATCH_SCALAR)
+#define AABB_BATCH_WIDTH 1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define AABB_BATCH_WIDTH 8
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AABB_BATCH_WIDTH 4
+#else
+#define AABB_BATCH_WIDTH 1
+#endif
+
+namespace {
+
+bool overlaps(const glm::vec3 &min, const glm::vec3 &max, const AabbColumns &boxes, int i) {
+    return (min.x <= boxes.maxX[i] && max.x >= boxes.minX[i]) &&
+           (min.y <= boxes.maxY[i] && max.y >= boxes.minY[i]) &&
+           (min.z <= boxes.maxZ[i] && max.z >= boxes.minZ[i]);
+}
+
+// one bit per box of the batch starting at i, the tail is done one by one
+int batchMask(const glm::vec3 &min, const glm::vec3 &max, const AabbColumns &boxes, int i) {
+#if AABB_BATCH_WIDTH == 8
+    __m256 overlap = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(min.x), _mm256_loadu_ps(boxes.maxX + i), _CMP_LE_OQ),
+                          _mm256_cmp_ps(_mm256_set1_ps(max.x), _mm256_loadu_ps(boxes.minX + i), _CMP_GE_OQ)),
+            _mm256_and_ps(
+                    _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(min.y), _mm256_loadu_ps(boxes.maxY + i), _CMP_LE_OQ),
+                                  _mm256_cmp_ps(_mm256_set1_ps(max.y), _mm256_loadu_ps(boxes.minY + i), _CMP_GE_OQ)),
+                    _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(min.z), _mm256_loadu_ps(boxes.maxZ + i), _CMP_LE_OQ),
+                                  _mm256_cmp_ps(_mm256_set1_ps(max.z), _mm256_loadu_ps(boxes.minZ + i), _CMP_GE_OQ))));
+    return _mm256_movemask_ps(overlap);
+#elif AABB_BATCH_WIDTH == 4
+    __m128 overlap = _mm_and_ps(
+            _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(min.x), _mm_loadu_ps(boxes.maxX + i)),
+                       _mm_cmpge_ps(_mm_set1_ps(max.x), _mm_loadu_ps(boxes.minX + i))),
+            _mm_and_ps(_mm_and_ps(_mm_cmple_ps(_mm_set1_ps(min.y), _mm_loadu_ps(boxes.maxY + i)),
+                                  _mm_cmpge_ps(_mm_set1_ps(max.y), _mm_loadu_ps(boxes.minY + i))),
+                       _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(min.z), _mm_loadu_ps(boxes.maxZ + i)),
+                                  _mm_cmpge_ps(_mm_set1_ps(max.z), _mm_loadu_ps(boxes.minZ + i)))));
+    return _mm_movemask_ps(overlap);
+#else
+    return overlaps(min, max, boxes, i) ? 1 : 0;
+#endif
+}
+
+int lowestBit(std::uint32_t bits) {
+    int bit = 0;
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        bit++;
+    }
+    return bit;
+}
+
+} // namespace
+
+int aabbBatchWidth() {
+    return AABB_BATCH_WIDTH;
+}
+
+int overlapBatch(const glm::vec3 &min, const glm::vec3 &max, const AabbColumns &boxes, int begin, int end,
+                 std::vector<std::uint64_t> &hitMask) {
+    int count = end > begin ? end - begin : 0;
+    hitMask.assign((count + 63) / 64, 0);
+
+    int first = -1;
+    int i = begin;
+    // AABB_BATCH_WIDTH divides 64, a batch never straddles two mask words
+    for (; i + AABB_BATCH_WIDTH <= end; i += AABB_BATCH_WIDTH) {
+        std::uint32_t bits = static_cast<std::uint32_t>(batchMask(min, max, boxes, i));
+        if (bits) {
+            int offset = i - begin;
+            hitMask[offset / 64] |= static_cast<std::uint64_t>(bits) << (offset % 64);
+            if (first < 0) {
+                first = i + lowestBit(bits);
+            }
+        }
+    }
+    for (; i < end; i++) {
+        if (overlaps(min, max, boxes, i)) {
+            int offset = i - begin;
+            hitMask[offset / 64] |= static_cast<std::uint64_t>(1) << (offset % 64);
+            if (first < 0) {
+                first = i;
+            }
+        }
+    }
+    return first;
+}
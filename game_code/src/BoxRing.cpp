@@ -0,0 +1,102 @@
+#include "BoxRing.hpp"
+
+#include <algorithm>
+
+BoxRing::BoxRing(int capacity)
+        : slotCapacity(std::max(capacity, 1)),
+          minXColumn(slotCapacity), minYColumn(slotCapacity), minZColumn(slotCapacity),
+          maxXColumn(slotCapacity), maxYColumn(slotCapacity), maxZColumn(slotCapacity) {}
+
+int BoxRing::pushBox(const glm::vec3 &min, const glm::vec3 &max) {
+    if (full()) {
+        return -1;
+    }
+    int slot = (head + count) % slotCapacity;
+    minXColumn[slot] = min.x;
+    minYColumn[slot] = min.y;
+    minZColumn[slot] = min.z;
+    maxXColumn[slot] = max.x;
+    maxYColumn[slot] = max.y;
+    maxZColumn[slot] = max.z;
+    count++;
+    return slot;
+}
+
+void BoxRing::popOldest() {
+    if (count > 0) {
+        head = (head + 1) % slotCapacity;
+        count--;
+    }
+}
+
+void BoxRing::clear() {
+    head = 0;
+    count = 0;
+}
+
+int BoxRing::liveRanges(Range ranges[2]) const {
+    if (count == 0) {
+        return 0;
+    }
+    int end = head + count;
+    if (end <= slotCapacity) {
+        ranges[0] = Range{head, end};
+        return 1;
+    }
+    ranges[0] = Range{head, slotCapacity};
+    ranges[1] = Range{0, end - slotCapacity};
+    return 2;
+}
+
+int BoxRing::oldest() const {
+    return count == 0 ? -1 : head;
+}
+
+int BoxRing::newest() const {
+    return count == 0 ? -1 : (head + count - 1) % slotCapacity;
+}
+
+int BoxRing::size() const {
+    return count;
+}
+
+int BoxRing::capacity() const {
+    return slotCapacity;
+}
+
+bool BoxRing::empty() const {
+    return count == 0;
+}
+
+bool BoxRing::full() const {
+    return count == slotCapacity;
+}
+
+const float *BoxRing::minX() const {
+    return minXColumn.data();
+}
+
+const float *BoxRing::minY() const {
+    return minYColumn.data();
+}
+
+const float *BoxRing::minZ() const {
+    return minZColumn.data();
+}
+
+const float *BoxRing::maxX() const {
+    return maxXColumn.data();
+}
+
+const float *BoxRing::maxY() const {
+    return maxYColumn.data();
+}
+
+const float *BoxRing::maxZ() const {
+    return maxZColumn.data();
+}
+
+AabbColumns BoxRing::boxes() const {
+    AabbColumns columns = {minX(), minY(), minZ(), maxX(), maxY(), maxZ()};
+    return columns;
+}
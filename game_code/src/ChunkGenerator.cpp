@@ -0,0 +1,219 @@
+#include "ChunkGenerator.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "CoinStore.hpp"
+#include "ObstaclePatterns.hpp"
+
+namespace {
+
+// patterns drawn for one chunk before its obstacles get dropped instead
+const int MAX_ATTEMPTS = 8;
+
+// random slots of one attempt: the pattern, its jitter, then one lane per
+// spawn. Every attempt has its own, so a chunk is the same however many
+// draws the attempts before it made.
+const int PATTERN_SLOT = 0;
+const int JITTER_SLOT = 1;
+const int LANE_SLOT = 2;
+const int SLOTS_PER_ATTEMPT = LANE_SLOT + Chunk::MAX_OBSTACLES;
+// the coin slots follow those of the last attempt
+const int COIN_SLOT = MAX_ATTEMPTS * SLOTS_PER_ATTEMPT;
+
+// chance of a coin trail in a chunk, of a second one next to it, and of a
+// trail staying in the lane of the previous one
+const float COIN_TRAIL_CHANCE = 0.6f;
+const float COIN_PAIR_CHANCE = 0.15f;
+const float COIN_KEEP_LANE = 0.7f;
+const float COIN_SPACING = 0.25f;
+// coins this close to an obstacle that has to be jumped sit at the top of
+// the jump
+const float COIN_CLEARANCE = 0.25f;
+
+} // namespace
+
+ChunkGenerator::ChunkGenerator(const std::vector<float> &lanes, float chunkLength, float startDistance,
+                               int lookAhead, std::uint64_t seed, const SolvabilityChecker &checker)
+        : lanes(lanes), laneCount(static_cast<int>(lanes.size())), chunkLength(chunkLength),
+          nextDistance(startDistance), seed(seed), checker(checker), ballBottom(checker.getStandingBottom()),
+          ballTop(checker.getStandingTop()), coinJumpHeight(checker.getJumpHeight()),
+          queue(static_cast<std::size_t>(std::max(lookAhead, 1))), stopping(false) {
+    // the stretch before the first chunk is free: the player can be in any
+    // lane by the time it starts, and already in the middle of an action
+    reach = this->checker.groundStates();
+    previous.startDistance = startDistance - chunkLength;
+    previous.count = 0;
+    previous.coinCount = 0;
+    this->checker.advance(previous.startDistance, previous.obstacles, 0, reach);
+    while (!queue.full()) {
+        queue.push(generate());
+    }
+    worker = std::thread(&ChunkGenerator::run, this);
+}
+
+ChunkGenerator::~ChunkGenerator() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+const Chunk *ChunkGenerator::front() const {
+    return queue.front();
+}
+
+void ChunkGenerator::pop() {
+    queue.pop();
+    // the lock only orders the notify against the worker going to sleep
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+}
+
+void ChunkGenerator::run() {
+    while (!stopping) {
+        while (!queue.full() && !stopping) {
+            queue.push(generate());
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        // the timeout only guards against a missed wake-up
+        wake.wait_for(lock, std::chrono::milliseconds(100), [this] { return stopping || !queue.full(); });
+    }
+}
+
+int ChunkGenerator::pickPattern(const CounterRng &rng, std::uint64_t slot) {
+    float total = 0.0f;
+    for (const ObstaclePattern &pattern : OBSTACLE_PATTERNS) {
+        total += pattern.weight;
+    }
+    float roll = rng.uniform(slot, 0.0f, total);
+    for (int i = 0; i < OBSTACLE_PATTERN_COUNT; i++) {
+        roll -= OBSTACLE_PATTERNS[i].weight;
+        if (roll < 0.0f) {
+            return i;
+        }
+    }
+    return OBSTACLE_PATTERN_COUNT - 1;
+}
+
+Chunk ChunkGenerator::generate() {
+    float startDistance = nextDistance;
+    nextDistance += chunkLength;
+    CounterRng rng(seed, chunkIndex++);
+
+    Chunk chunk;
+    bool found = false;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS && !found; attempt++) {
+        chunk = build(startDistance, rng, static_cast<std::uint64_t>(attempt) * SLOTS_PER_ATTEMPT);
+        found = passable(chunk);
+    }
+    // the last draw is repaired from the far end. An empty chunk is only
+    // blocked when the previous obstacles close every way out of it, then
+    // the run goes on from the ground rather than stall
+    while (!found) {
+        if (chunk.count == 0) {
+            reach = checker.groundStates();
+            break;
+        }
+        chunk.count--;
+        found = passable(chunk);
+    }
+
+    placeCoins(chunk, rng);
+    previous = chunk;
+    return chunk;
+}
+
+Chunk ChunkGenerator::build(float startDistance, const CounterRng &rng, std::uint64_t firstSlot) {
+    Chunk chunk;
+    chunk.startDistance = startDistance;
+    chunk.count = 0;
+    chunk.coinCount = 0;
+
+    const ObstaclePattern &pattern = OBSTACLE_PATTERNS[pickPattern(rng, firstSlot + PATTERN_SLOT)];
+    float shift = rng.uniform(firstSlot + JITTER_SLOT, -pattern.jitter, pattern.jitter);
+
+    for (int i = 0; i < pattern.count; i++) {
+        const PatternSpawn &spawn = pattern.spawns[i];
+        const ObstacleTraits &traits = obstacleTraits(spawn.kind);
+
+        ObstacleSpawn &obstacle = chunk.obstacles[chunk.count++];
+        obstacle.kind = spawn.kind;
+        obstacle.lane = spawn.lane != KIND_LANE ? spawn.lane : traits.lane;
+        if (obstacle.lane == ANY_LANE) {
+            obstacle.lane = rng.uniformInt(firstSlot + LANE_SLOT + i, 0, laneCount - 1);
+        }
+        obstacle.distance = startDistance + chunkLength * std::min(std::max(spawn.offset + shift, 0.0f), 1.0f);
+    }
+    return chunk;
+}
+
+bool ChunkGenerator::passable(const Chunk &chunk) {
+    ObstacleSpawn obstacles[2 * Chunk::MAX_OBSTACLES];
+    int count = 0;
+    for (int i = 0; i < previous.count; i++) {
+        obstacles[count++] = previous.obstacles[i];
+    }
+    for (int i = 0; i < chunk.count; i++) {
+        obstacles[count++] = chunk.obstacles[i];
+    }
+    return checker.advance(chunk.startDistance, obstacles, count, reach);
+}
+
+void ChunkGenerator::placeCoins(Chunk &chunk, const CounterRng &rng) {
+    if (rng.uniform(COIN_SLOT, 0.0f, 1.0f) >= COIN_TRAIL_CHANCE) {
+        coinLane = -1;
+        return;
+    }
+    bool keepLane = coinLane >= 0 && rng.uniform(COIN_SLOT + 1, 0.0f, 1.0f) < COIN_KEEP_LANE;
+    int lane = keepLane ? coinLane : rng.uniformInt(COIN_SLOT + 2, 0, laneCount - 1);
+    addTrail(chunk, lane);
+    if (laneCount > 1 && rng.uniform(COIN_SLOT + 3, 0.0f, 1.0f) < COIN_PAIR_CHANCE) {
+        addTrail(chunk, (lane + rng.uniformInt(COIN_SLOT + 4, 1, laneCount - 1)) % laneCount);
+    }
+    coinLane = lane;
+}
+
+void ChunkGenerator::addTrail(Chunk &chunk, int lane) const {
+    int count = static_cast<int>(chunkLength / COIN_SPACING);
+    for (int i = 0; i < count && chunk.coinCount < Chunk::MAX_COINS; i++) {
+        float distance = chunk.startDistance + (i + 0.5f) * chunkLength / count;
+        bool jump = obstacleNear(chunk, lane, distance, COIN_CLEARANCE, ballBottom, ballTop);
+        float height = jump ? coinJumpHeight : 0.0f;
+        // e.g. under a raised trunk right behind a fallen one
+        float center = (ballBottom + ballTop) * 0.5f + height;
+        if (obstacleNear(chunk, lane, distance, COIN_RADIUS, center - COIN_RADIUS, center + COIN_RADIUS)) {
+            continue;
+        }
+
+        CoinSpawn &coin = chunk.coins[chunk.coinCount++];
+        coin.lane = lane;
+        coin.distance = distance;
+        coin.height = height;
+    }
+}
+
+bool ChunkGenerator::obstacleNear(const Chunk &chunk, int lane, float distance, float reach, float bottom,
+                                  float top) const {
+    const Chunk *nearby[] = {&previous, &chunk};
+    for (const Chunk *source : nearby) {
+        for (int i = 0; i < source->count; i++) {
+            const ObstacleSpawn &obstacle = source->obstacles[i];
+            const ObstacleTraits &traits = obstacleTraits(obstacle.kind);
+            float x = lanes[lane] - lanes[obstacle.lane];
+            // distances grow along -z
+            float z = obstacle.distance - distance;
+            if (x >= traits.boxMin[0] && x <= traits.boxMax[0] && traits.boxMin[1] <= top &&
+                traits.boxMax[1] >= bottom && z >= traits.boxMin[2] - reach && z <= traits.boxMax[2] + reach) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,93 @@
+#include "CoinRenderer.hpp"
+
+#include "GLState.hpp"
+#include "VertexFormat.hpp"
+
+namespace {
+
+const std::string shader_location("../res/shaders/");
+
+// keep in sync with coin.vert
+const GLuint ATTRIB_INSTANCE = 3;
+
+const float COIN_THICKNESS = 0.015f;
+const int COIN_SEGMENTS = 24;
+
+} // namespace
+
+CoinRenderer::CoinRenderer(int capacity)
+        : capacity(capacity), shader(shader_location + "coin.vert", shader_location + "coin.frag") {
+    // a disc facing the player, the shader turns it around y
+    MeshBuilder builder;
+    glm::vec3 back(0.0f, 0.0f, -0.5f * COIN_THICKNESS);
+    glm::vec3 front(0.0f, 0.0f, 0.5f * COIN_THICKNESS);
+    builder.addCylinder(back, front - back, COIN_RADIUS, COIN_SEGMENTS, glm::vec2(1.0f, 1.0f));
+    builder.addCap(front, glm::vec3(0.0f, 0.0f, 1.0f), COIN_RADIUS, COIN_SEGMENTS);
+    builder.addCap(back, glm::vec3(0.0f, 0.0f, -1.0f), COIN_RADIUS, COIN_SEGMENTS);
+    builder.optimize();
+    coinMesh = builder.build();
+    coinMesh.upload();
+    // rim and both faces are drawn together, the whole mesh is one coin
+    coin.firstIndex = 0;
+    coin.indexCount = static_cast<GLsizei>(coinMesh.indices.size());
+
+    // every slot starts out hidden
+    std::vector<glm::vec4> initial(capacity, glm::vec4(0.0f));
+    glGenBuffers(1, &instanceVBO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(initial.size() * sizeof(glm::vec4)), initial.data(),
+                 GL_DYNAMIC_DRAW);
+
+    GLState::bindVertexArray(coinMesh.VAO);
+    VertexFormat(sizeof(glm::vec4)).add(ATTRIB_INSTANCE, 4, GL_FLOAT, GL_FALSE, 0).apply();
+    glVertexAttribDivisor(ATTRIB_INSTANCE, 1);
+    GLState::bindVertexArray(0);
+
+    shader.use();
+    shader.setVec3("fogColor", glm::vec3(0.5f, 0.5f, 0.5f));
+    shader.setFloat("fogStart", 4.0f);
+    shader.setFloat("fogEnd", 13.0f);
+}
+
+void CoinRenderer::apply(const std::vector<CoinUpdate> &updates) {
+    if (updates.empty()) {
+        return;
+    }
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    std::size_t i = 0;
+    while (i < updates.size()) {
+        int first = updates[i].slot;
+        staging.clear();
+        for (; i < updates.size() && updates[i].slot == first + static_cast<int>(staging.size()); i++) {
+            staging.push_back(glm::vec4(updates[i].position, updates[i].visible ? 1.0f : 0.0f));
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(glm::vec4)),
+                        static_cast<GLsizeiptr>(staging.size() * sizeof(glm::vec4)), staging.data());
+    }
+}
+
+void CoinRenderer::draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition,
+                        float time) {
+    shader.use();
+    shader.setMat4("view", view);
+    shader.setMat4("projection", projection);
+    shader.setVec3("cameraPos", cameraPosition);
+    shader.setFloat("time", time);
+
+    // the disc is thin enough to be seen edge on, both sides are drawn
+    GLState::setEnabled(GL_CULL_FACE, false);
+    GLState::setEnabled(GL_BLEND, false);
+    GLState::bindVertexArray(coinMesh.VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, coin.indexCount, GL_UNSIGNED_INT,
+                            reinterpret_cast<void *>(coin.firstIndex * sizeof(GLuint)), capacity);
+}
+
+void CoinRenderer::release() {
+    coinMesh.release();
+    GLState::deleteBuffers(1, &instanceVBO);
+    GLState::deleteProgram(shader.ID);
+}
+
+int CoinRenderer::getCapacity() const {
+    return capacity;
+}
@@ -0,0 +1,39 @@
+#include "CoinStore.hpp"
+
+CoinStore::CoinStore(int capacity)
+        : BoxRing(capacity),
+          xColumn(this->capacity()), yColumn(this->capacity()), zColumn(this->capacity()),
+          collected((this->capacity() + 63) / 64, 0) {}
+
+bool CoinStore::push(const glm::vec3 &position) {
+    int slot = pushBox(position - glm::vec3(COIN_RADIUS), position + glm::vec3(COIN_RADIUS));
+    if (slot < 0) {
+        return false;
+    }
+
+    xColumn[slot] = position.x;
+    yColumn[slot] = position.y;
+    zColumn[slot] = position.z;
+    collected[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+    return true;
+}
+
+bool CoinStore::isCollected(int slot) const {
+    return (collected[slot / 64] >> (slot % 64)) & 1;
+}
+
+void CoinStore::collect(int slot) {
+    collected[slot / 64] |= std::uint64_t(1) << (slot % 64);
+}
+
+const float *CoinStore::positionX() const {
+    return xColumn.data();
+}
+
+const float *CoinStore::positionY() const {
+    return yColumn.data();
+}
+
+const float *CoinStore::positionZ() const {
+    return zColumn.data();
+}
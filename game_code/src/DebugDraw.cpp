@@ -0,0 +1,82 @@
+#include "DebugDraw.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include "GLState.hpp"
+#include "VertexFormat.hpp"
+
+bool DebugDraw::active = false;
+std::vector<DebugVertex> *DebugDraw::target = nullptr;
+
+void DebugDraw::begin(std::vector<DebugVertex> *lines) {
+    target = lines;
+    if (target) {
+        target->clear();
+    }
+}
+
+std::uint32_t DebugDraw::rgba(float r, float g, float b, float a) {
+    return glm::packUnorm4x8(glm::vec4(r, g, b, a));
+}
+
+void DebugDraw::addLine(const glm::vec3 &from, const glm::vec3 &to, std::uint32_t color) {
+    DebugVertex a = {from, color};
+    DebugVertex b = {to, color};
+    target->push_back(a);
+    target->push_back(b);
+}
+
+void DebugDraw::addBox(const glm::vec3 &min, const glm::vec3 &max, std::uint32_t color) {
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; i++) {
+        corners[i] = glm::vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+    }
+    // the 12 edges connect corners that differ in exactly one bit
+    for (int i = 0; i < 8; i++) {
+        for (int bit = 1; bit < 8; bit <<= 1) {
+            if (!(i & bit)) {
+                addLine(corners[i], corners[i | bit], color);
+            }
+        }
+    }
+}
+
+DebugDrawRenderer::DebugDrawRenderer() : shader("../res/shaders/debug.vert", "../res/shaders/debug.frag") {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    GLState::bindVertexArray(VAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    VertexFormat(sizeof(DebugVertex))
+            .add(0, 3, GL_FLOAT, GL_FALSE, offsetof(DebugVertex, position))
+            .add(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(DebugVertex, color))
+            .apply();
+    GLState::bindVertexArray(0);
+}
+
+void DebugDrawRenderer::draw(const std::vector<DebugVertex> &lines, const glm::mat4 &viewProjection) {
+    if (lines.empty()) {
+        return;
+    }
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(lines.size() * sizeof(DebugVertex));
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (size > capacity) {
+        capacity = size * 2;
+    }
+    // orphan last frame's storage so the upload never waits for the GPU
+    glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, lines.data());
+
+    shader.use();
+    shader.setMat4("viewProjection", viewProjection);
+    GLState::setEnabled(GL_DEPTH_TEST, false);
+    GLState::bindVertexArray(VAO);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(lines.size()));
+    GLState::setEnabled(GL_DEPTH_TEST, true);
+}
+
+void DebugDrawRenderer::release() {
+    GLState::deleteVertexArrays(1, &VAO);
+    GLState::deleteBuffers(1, &VBO);
+    GLState::deleteProgram(shader.ID);
+}
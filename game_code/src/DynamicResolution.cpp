@@ -0,0 +1,152 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "GLState.hpp"
+
+DynamicResolution::DynamicResolution(int windowWidth, int windowHeight, float targetSceneMs)
+        : windowWidth(windowWidth), windowHeight(windowHeight), targetSceneMs(targetSceneMs) {
+    glGenQueries(QUERY_COUNT, queries);
+    allocateTargets();
+}
+
+void DynamicResolution::resize(int width, int height) {
+    if (width == windowWidth && height == windowHeight) {
+        return;
+    }
+    windowWidth = width;
+    windowHeight = height;
+
+    glDeleteFramebuffers(1, &fbo);
+    GLState::deleteTextures(1, &colorTexture);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    allocateTargets();
+}
+
+void DynamicResolution::beginScene() {
+    readQueries();
+
+    if (enabled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    }
+    glViewport(0, 0, getSceneWidth(), getSceneHeight());
+
+    // the slot is still in flight when the GPU is more than QUERY_COUNT
+    // frames behind, this frame then simply goes untimed
+    if (!queryPending[queryIndex]) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+    }
+}
+
+void DynamicResolution::endScene() {
+    if (!queryPending[queryIndex]) {
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryIndex] = true;
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+    }
+
+    if (enabled) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, getSceneWidth(), getSceneHeight(), 0, 0, windowWidth, windowHeight,
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    glViewport(0, 0, windowWidth, windowHeight);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void DynamicResolution::release() {
+    glDeleteQueries(QUERY_COUNT, queries);
+    glDeleteFramebuffers(1, &fbo);
+    GLState::deleteTextures(1, &colorTexture);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    fbo = colorTexture = depthBuffer = 0;
+}
+
+float DynamicResolution::getScale() const {
+    return scale;
+}
+
+float DynamicResolution::getSceneMs() const {
+    return smoothedSceneMs;
+}
+
+int DynamicResolution::getSceneWidth() const {
+    return std::max(1, static_cast<int>(windowWidth * scale));
+}
+
+int DynamicResolution::getSceneHeight() const {
+    return std::max(1, static_cast<int>(windowHeight * scale));
+}
+
+// The targets always have the full window size and the scene is drawn into
+// the lower left corner, so changing the scale never reallocates anything.
+void DynamicResolution::allocateTargets() {
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenTextures(1, &colorTexture);
+    GLState::bindTexture(0, GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, windowWidth, windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, windowWidth, windowHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    enabled = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!enabled) {
+        std::cout << "ERROR::DYNAMIC_RESOLUTION::FRAMEBUFFER_INCOMPLETE, rendering at native resolution"
+                  << std::endl;
+        scale = 1.0f;
+    }
+
+    GLState::bindTexture(0, GL_TEXTURE_2D, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void DynamicResolution::readQueries() {
+    // oldest query first, stop at the first one the GPU has not finished
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        int slot = (queryIndex + i) % QUERY_COUNT;
+        if (!queryPending[slot]) {
+            continue;
+        }
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &elapsed);
+        queryPending[slot] = false;
+        updateScale(static_cast<float>(elapsed) / 1.0e6f);
+    }
+}
+
+void DynamicResolution::updateScale(float sceneMs) {
+    smoothedSceneMs = smoothedSceneMs == 0.0f ? sceneMs : smoothedSceneMs + 0.1f * (sceneMs - smoothedSceneMs);
+    if (!enabled || smoothedSceneMs <= 0.0f) {
+        return;
+    }
+
+    // pixel count goes with scale^2, so the time per pixel tells us the
+    // scale that would just fit the budget
+    float desired = scale * std::sqrt(targetSceneMs / smoothedSceneMs);
+    desired = std::min(std::max(desired, minScale), maxScale);
+
+    // small dead band against oscillation and a bounded step per update so
+    // the smoothed time can catch up with the new scale
+    float step = desired - scale;
+    if (std::abs(step) < 0.02f) {
+        return;
+    }
+    scale += std::min(std::max(step, -0.05f), 0.05f);
+}
@@ -0,0 +1,23 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(double step, double maxFrameTime) : step(step), maxFrameTime(maxFrameTime) {}
+
+int FixedTimestep::advance(double frameTime) {
+    accumulator += std::min(std::max(frameTime, 0.0), maxFrameTime);
+    int steps = 0;
+    while (accumulator >= step) {
+        accumulator -= step;
+        steps++;
+    }
+    return steps;
+}
+
+float FixedTimestep::getStep() const {
+    return static_cast<float>(step);
+}
+
+float FixedTimestep::getAlpha() const {
+    return static_cast<float>(accumulator / step);
+}
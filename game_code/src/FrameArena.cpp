@@ -0,0 +1,68 @@
+#include "FrameArena.hpp"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <new>
+
+FrameArena::FrameArena(std::size_t capacity, const char *name)
+        : block(static_cast<char *>(::operator new(capacity))), capacity(capacity), name(name) {}
+
+FrameArena::~FrameArena() {
+    reset();
+    ::operator delete(block);
+}
+
+void *FrameArena::allocate(std::size_t size, std::size_t alignment) {
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block) + used;
+    std::size_t padding = (alignment - start % alignment) % alignment;
+    if (padding + size <= capacity - used) {
+        void *memory = block + used + padding;
+        used += padding + size;
+        return memory;
+    }
+
+    // over budget, the heap covers the rest of the frame; operator new is
+    // aligned for every type the game puts in an arena
+    void *memory = ::operator new(size);
+    spills.push_back(memory);
+    spilled += size;
+    return memory;
+}
+
+void FrameArena::reset() {
+    std::size_t demand = used + spilled;
+    if (demand > highWater) {
+        highWater = demand;
+    }
+    if (spilled > reportedOverflow) {
+        reportedOverflow = spilled;
+        std::cout << "ARENA::OVERFLOW " << name << " needed " << demand << " of " << capacity << " bytes"
+                  << std::endl;
+    }
+
+    for (void *memory : spills) {
+        ::operator delete(memory);
+    }
+    spills.clear();
+    spilled = 0;
+    used = 0;
+}
+
+const char *FrameArena::format(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = std::vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+
+    char *text = static_cast<char *>(allocate(length > 0 ? length + 1 : 1, 1));
+    text[0] = '\0';
+    if (length > 0) {
+        std::vsnprintf(text, length + 1, format, args);
+    }
+    va_end(args);
+    return text;
+}
@@ -0,0 +1,347 @@
+#include "FrameCapture.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "GLState.hpp"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+void makeDirectory(const std::string &dir) {
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+}
+
+unsigned char clampByte(float value) {
+    return static_cast<unsigned char>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+
+} // namespace
+
+FrameCapture::FrameCapture() {
+    for (Readback &readback : ring) {
+        glGenBuffers(1, &readback.pbo);
+        readback.size = 0;
+        readback.fence = 0;
+    }
+    worker = std::thread(&FrameCapture::workerLoop, this);
+}
+
+void FrameCapture::requestScreenshot() {
+    screenshotRequested = true;
+}
+
+void FrameCapture::setRecording(bool enabled) {
+    if (enabled == recording) {
+        return;
+    }
+    recording = enabled;
+    if (enabled) {
+        Job job = {JobType::VIDEO_START, makePath("recording", ".y4m"), 0, 0, 0, {}};
+        enqueue(job);
+        recordStart = Clock::now();
+        recordedFrames = 0;
+        droppedFrames = 0;
+    } else {
+        // frames still in flight belong before the end of the stream
+        collectReadbacks(true);
+        Job job = {JobType::VIDEO_END, "", 0, 0, 0, {}};
+        enqueue(job);
+        std::cout << "CAPTURE::RECORDING stopped, " << recordedFrames << " frames, " << droppedFrames
+                  << " dropped" << std::endl;
+    }
+}
+
+bool FrameCapture::isRecording() const {
+    return recording;
+}
+
+void FrameCapture::capture(int width, int height) {
+    collectReadbacks(false);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    if (screenshotRequested) {
+        screenshotRequested = false;
+        startReadback(JobType::SCREENSHOT, width, height, 1);
+    }
+
+    if (recording) {
+        // how many frames of the fixed-rate stream are due by now; a slow
+        // frame is repeated so the video keeps real-time speed
+        double elapsed = std::chrono::duration<double>(Clock::now() - recordStart).count();
+        long long due = static_cast<long long>(std::floor(elapsed * recordFps)) + 1 - recordedFrames;
+        if (due > 0) {
+            // after a long pause (minimized window) hold the last image for
+            // at most a second instead of writing minutes of copies
+            int repeat = static_cast<int>(std::min(due, static_cast<long long>(recordFps)));
+            startReadback(JobType::VIDEO_FRAME, width, height, repeat);
+            recordedFrames += due;
+        }
+    }
+}
+
+void FrameCapture::startReadback(JobType type, int width, int height, int repeat) {
+    Readback &readback = ring[next];
+    if (readback.fence && !finishReadback(readback, false)) {
+        if (type == JobType::VIDEO_FRAME) {
+            droppedFrames += repeat;
+            return;
+        }
+        finishReadback(readback, true);
+    }
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    if (size != readback.size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        readback.size = size;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.type = type;
+    readback.width = width;
+    readback.height = height;
+    readback.repeat = repeat;
+    next = (next + 1) % RING_SIZE;
+}
+
+bool FrameCapture::finishReadback(Readback &readback, bool wait) {
+    GLenum status = glClientWaitSync(readback.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                     wait ? 1000000000ull : 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
+    }
+    glDeleteSync(readback.fence);
+    readback.fence = 0;
+    if (status == GL_WAIT_FAILED) {
+        std::cout << "ERROR::CAPTURE::READBACK_FAILED" << std::endl;
+        return true;
+    }
+
+    Job job = {readback.type, "", readback.width, readback.height, readback.repeat, {}};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (readback.type == JobType::VIDEO_FRAME && jobs.size() >= maxQueuedFrames) {
+            // the encoder cannot keep up, better a gap than a stall
+            droppedFrames += readback.repeat;
+            return true;
+        }
+        if (!spareBuffers.empty()) {
+            job.pixels.swap(spareBuffers.back());
+            spareBuffers.pop_back();
+        }
+    }
+    if (job.type == JobType::SCREENSHOT) {
+        job.path = makePath("screenshot", ".png");
+    }
+
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    const unsigned char *mapped = static_cast<const unsigned char *>(
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.size, GL_MAP_READ_BIT));
+    if (mapped) {
+        // GL rows start at the bottom, images at the top
+        std::size_t rowSize = static_cast<std::size_t>(readback.width) * 4;
+        job.pixels.resize(rowSize * readback.height);
+        for (int y = 0; y < readback.height; y++) {
+            std::memcpy(&job.pixels[y * rowSize], mapped + (readback.height - 1 - y) * rowSize, rowSize);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (mapped) {
+        enqueue(job);
+    } else {
+        std::cout << "ERROR::CAPTURE::MAP_FAILED" << std::endl;
+    }
+    return true;
+}
+
+void FrameCapture::collectReadbacks(bool wait) {
+    // oldest first, readbacks complete in the order they were issued
+    for (int i = 0; i < RING_SIZE; i++) {
+        Readback &readback = ring[(next + i) % RING_SIZE];
+        if (readback.fence && !finishReadback(readback, wait)) {
+            return;
+        }
+    }
+}
+
+void FrameCapture::enqueue(Job &job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+std::string FrameCapture::makePath(const char *prefix, const char *extension) {
+    makeDirectory(directory);
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+    std::ostringstream path;
+    path << directory << prefix << "_" << stamp << "_" << captureCounter++ << extension;
+    return path.str();
+}
+
+void FrameCapture::release() {
+    if (recording) {
+        setRecording(false);
+    }
+    collectReadbacks(true);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    for (Readback &readback : ring) {
+        if (readback.fence) {
+            glDeleteSync(readback.fence);
+            readback.fence = 0;
+        }
+        GLState::deleteBuffers(1, &readback.pbo);
+    }
+}
+
+void FrameCapture::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                break;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        switch (job.type) {
+            case JobType::SCREENSHOT:
+                writeScreenshot(job);
+                break;
+            case JobType::VIDEO_START:
+                video.open(job.path.c_str(), std::ios::binary);
+                videoWidth = 0;
+                videoHeight = 0;
+                if (!video) {
+                    std::cout << "ERROR::CAPTURE::CANNOT_OPEN " << job.path << std::endl;
+                } else {
+                    std::cout << "CAPTURE::RECORDING " << job.path << std::endl;
+                }
+                break;
+            case JobType::VIDEO_FRAME:
+                writeVideoFrame(job);
+                break;
+            case JobType::VIDEO_END:
+                video.close();
+                break;
+        }
+
+        if (!job.pixels.empty()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            spareBuffers.push_back(std::move(job.pixels));
+        }
+    }
+    video.close();
+}
+
+void FrameCapture::writeScreenshot(const Job &job) {
+    // blending leaves the back buffer's alpha below 255 wherever fog,
+    // particles or text were drawn, so only the color is written
+    std::size_t pixelCount = static_cast<std::size_t>(job.width) * job.height;
+    std::vector<unsigned char> rgb(pixelCount * 3);
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        rgb[i * 3] = job.pixels[i * 4];
+        rgb[i * 3 + 1] = job.pixels[i * 4 + 1];
+        rgb[i * 3 + 2] = job.pixels[i * 4 + 2];
+    }
+    if (stbi_write_png(job.path.c_str(), job.width, job.height, 3, rgb.data(), job.width * 3)) {
+        std::cout << "CAPTURE::SCREENSHOT " << job.path << std::endl;
+    } else {
+        std::cout << "ERROR::CAPTURE::CANNOT_WRITE " << job.path << std::endl;
+    }
+}
+
+void FrameCapture::writeVideoFrame(const Job &job) {
+    if (!video.is_open()) {
+        return;
+    }
+    // 4:2:0 needs even dimensions, an odd last row or column is cropped
+    int width = job.width & ~1;
+    int height = job.height & ~1;
+    if (videoWidth == 0) {
+        videoWidth = width;
+        videoHeight = height;
+        video << "YUV4MPEG2 W" << width << " H" << height << " F" << static_cast<int>(recordFps)
+              << ":1 Ip A1:1 C420jpeg\n";
+    } else if (width != videoWidth || height != videoHeight) {
+        // the stream cannot change size
+        std::cout << "CAPTURE::RECORDING window resized, recording ended" << std::endl;
+        video.close();
+        return;
+    }
+
+    // full-range BT.601, chroma averaged over 2x2 blocks
+    std::size_t lumaSize = static_cast<std::size_t>(width) * height;
+    std::size_t chromaSize = lumaSize / 4;
+    videoPlanes.resize(lumaSize + 2 * chromaSize);
+    unsigned char *luma = &videoPlanes[0];
+    unsigned char *cb = luma + lumaSize;
+    unsigned char *cr = cb + chromaSize;
+    std::size_t stride = static_cast<std::size_t>(job.width) * 4;
+
+    for (int y = 0; y < height; y += 2) {
+        for (int x = 0; x < width; x += 2) {
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    const unsigned char *p = &job.pixels[(y + dy) * stride + (x + dx) * 4];
+                    luma[(y + dy) * width + x + dx] = clampByte(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            r *= 0.25f;
+            g *= 0.25f;
+            b *= 0.25f;
+            std::size_t c = (y / 2) * (width / 2) + x / 2;
+            cb[c] = clampByte(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+            cr[c] = clampByte(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+        }
+    }
+
+    for (int i = 0; i < job.repeat; i++) {
+        video << "FRAME\n";
+        video.write(reinterpret_cast<const char *>(videoPlanes.data()),
+                    static_cast<std::streamsize>(videoPlanes.size()));
+    }
+}
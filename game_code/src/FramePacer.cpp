@@ -0,0 +1,144 @@
+#include "FramePacer.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+double seconds(FramePacer::Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+FramePacer::Clock::duration toDuration(double seconds) {
+    return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+} // namespace
+
+FramePacer::FramePacer(SwapMode mode, double frameCap) : swapMode(mode), frameCap(frameCap) {
+    setSwapMode(mode);
+}
+
+void FramePacer::setSwapMode(SwapMode mode) {
+    swapMode = mode;
+    switch (mode) {
+        case SwapMode::VSYNC:
+            glfwSwapInterval(1);
+            break;
+        case SwapMode::ADAPTIVE_VSYNC:
+            // late frames tear instead of waiting a whole extra refresh
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+                glfwSwapInterval(-1);
+            } else {
+                std::cout << "FRAME_PACING::ADAPTIVE_VSYNC not supported, using VSYNC" << std::endl;
+                swapMode = SwapMode::VSYNC;
+                glfwSwapInterval(1);
+            }
+            break;
+        case SwapMode::IMMEDIATE:
+            glfwSwapInterval(0);
+            break;
+    }
+    deadlineValid = false;
+}
+
+void FramePacer::setFrameCap(double fps) {
+    frameCap = fps;
+    deadlineValid = false;
+}
+
+void FramePacer::setLowPower(bool enabled) {
+    if (lowPower != enabled) {
+        lowPower = enabled;
+        deadlineValid = false;
+    }
+}
+
+SwapMode FramePacer::getSwapMode() const {
+    return swapMode;
+}
+
+bool FramePacer::isLowPower() const {
+    return lowPower;
+}
+
+void FramePacer::waitForNextFrame() {
+    double cap = activeCap();
+    if (cap <= 0.0) {
+        return;
+    }
+    Clock::duration period = toDuration(1.0 / cap);
+    Clock::time_point now = Clock::now();
+
+    // after a hitch start a new schedule instead of rushing to catch up
+    if (!deadlineValid || now > deadline + period) {
+        deadline = now;
+        deadlineValid = true;
+    }
+
+    Clock::time_point wakeUp = lowPower ? deadline : deadline - toDuration(spinMargin);
+    if (now < wakeUp) {
+        std::this_thread::sleep_until(wakeUp);
+        double oversleep = seconds(Clock::now() - wakeUp);
+        if (oversleep > spinMargin) {
+            spinMargin = std::min(oversleep * 1.25, 0.004);
+        } else {
+            spinMargin = std::max(spinMargin * 0.99, 0.0005);
+        }
+    }
+    if (!lowPower) {
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+    deadline += period;
+}
+
+void FramePacer::endFrame() {
+    Clock::time_point now = Clock::now();
+    if (!lastFrameValid) {
+        lastFrameValid = true;
+        lastFrameEnd = now;
+        reportStart = now;
+        return;
+    }
+    double interval = seconds(now - lastFrameEnd);
+    lastFrameEnd = now;
+
+    frames++;
+    intervalSum += interval;
+    intervalSquareSum += interval * interval;
+    worstInterval = std::max(worstInterval, interval);
+
+    if (seconds(now - reportStart) >= reportInterval) {
+        report();
+        reportStart = now;
+        frames = 0;
+        intervalSum = intervalSquareSum = worstInterval = 0.0;
+    }
+}
+
+double FramePacer::activeCap() const {
+    if (lowPower) {
+        return frameCap > 0.0 ? std::min(frameCap, lowPowerFps) : lowPowerFps;
+    }
+    return frameCap;
+}
+
+// jitter is the standard deviation of the frame interval
+void FramePacer::report() {
+    if (frames == 0) {
+        return;
+    }
+    double mean = intervalSum / frames;
+    double jitter = std::sqrt(std::max(0.0, intervalSquareSum / frames - mean * mean));
+    std::cout << std::fixed << std::setprecision(2) << "FRAME_PACING:: " << 1.0 / mean << " fps, mean "
+              << mean * 1000.0 << " ms, jitter " << jitter * 1000.0 << " ms, worst " << worstInterval * 1000.0
+              << " ms" << (lowPower ? " (low power)" : "") << std::defaultfloat << std::endl;
+}
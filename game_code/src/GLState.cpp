@@ -0,0 +1,290 @@
+#include "GLState.hpp"
+
+#include <iostream>
+
+namespace {
+
+// a name GL never hands out, marks a shadow value as unknown
+const GLuint UNKNOWN = 0xffffffffu;
+const GLenum UNKNOWN_ENUM = 0xffffffffu;
+
+enum { ARRAY_BUFFER, PIXEL_PACK_BUFFER, TEXTURE_BUFFER_BINDING, BUFFER_TARGETS };
+enum { TEXTURE_2D_TARGET, TEXTURE_BUFFER_TARGET, TEXTURE_TARGETS };
+enum { DEPTH_TEST, CULL_FACE, BLEND, RASTERIZER_DISCARD, CAPABILITIES };
+// tri-state for the enable flags and masks
+enum { OFF = 0, ON = 1, UNSET = 2 };
+
+const char *const counterNames[GLState::COUNTER_COUNT] = {
+    "program", "vertex array", "buffer", "texture", "enable", "blend func", "depth", "color mask"};
+
+struct Shadow {
+    GLuint program;
+    GLuint vertexArray;
+    GLuint buffers[BUFFER_TARGETS];
+    GLuint activeUnit;
+    GLuint textures[GLState::MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+    int capabilities[CAPABILITIES];
+    GLenum blendSource;
+    GLenum blendDestination;
+    GLenum depthFunction;
+    int depthWrite;
+    int colorWrite;
+
+    unsigned long long issued[GLState::COUNTER_COUNT];
+    unsigned long long skipped[GLState::COUNTER_COUNT];
+};
+
+Shadow makeUnknown() {
+    Shadow shadow;
+    shadow.program = UNKNOWN;
+    shadow.vertexArray = UNKNOWN;
+    for (int i = 0; i < BUFFER_TARGETS; i++) {
+        shadow.buffers[i] = UNKNOWN;
+    }
+    shadow.activeUnit = UNKNOWN;
+    for (int unit = 0; unit < GLState::MAX_TEXTURE_UNITS; unit++) {
+        for (int i = 0; i < TEXTURE_TARGETS; i++) {
+            shadow.textures[unit][i] = UNKNOWN;
+        }
+    }
+    for (int i = 0; i < CAPABILITIES; i++) {
+        shadow.capabilities[i] = UNSET;
+    }
+    shadow.blendSource = UNKNOWN_ENUM;
+    shadow.blendDestination = UNKNOWN_ENUM;
+    shadow.depthFunction = UNKNOWN_ENUM;
+    shadow.depthWrite = UNSET;
+    shadow.colorWrite = UNSET;
+    for (int i = 0; i < GLState::COUNTER_COUNT; i++) {
+        shadow.issued[i] = 0;
+        shadow.skipped[i] = 0;
+    }
+    return shadow;
+}
+
+// only the render thread touches GL, so no locking
+Shadow state = makeUnknown();
+
+// true when the call has to reach GL, counts it either way
+bool change(GLState::Counter counter, bool needed) {
+    if (needed) {
+        state.issued[counter]++;
+    } else {
+        state.skipped[counter]++;
+    }
+    return needed;
+}
+
+int bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return ARRAY_BUFFER;
+    case GL_PIXEL_PACK_BUFFER:
+        return PIXEL_PACK_BUFFER;
+    case GL_TEXTURE_BUFFER:
+        return TEXTURE_BUFFER_BINDING;
+    default:
+        return -1;
+    }
+}
+
+int textureSlot(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D:
+        return TEXTURE_2D_TARGET;
+    case GL_TEXTURE_BUFFER:
+        return TEXTURE_BUFFER_TARGET;
+    default:
+        return -1;
+    }
+}
+
+int capabilitySlot(GLenum capability) {
+    switch (capability) {
+    case GL_DEPTH_TEST:
+        return DEPTH_TEST;
+    case GL_CULL_FACE:
+        return CULL_FACE;
+    case GL_BLEND:
+        return BLEND;
+    case GL_RASTERIZER_DISCARD:
+        return RASTERIZER_DISCARD;
+    default:
+        return -1;
+    }
+}
+
+void selectUnit(GLuint unit) {
+    if (state.activeUnit != unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        state.activeUnit = unit;
+    }
+}
+
+} // namespace
+
+void GLState::useProgram(GLuint program) {
+    if (change(PROGRAM, state.program != program)) {
+        glUseProgram(program);
+        state.program = program;
+    }
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (change(VERTEX_ARRAY, state.vertexArray != vertexArray)) {
+        glBindVertexArray(vertexArray);
+        state.vertexArray = vertexArray;
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferSlot(target);
+    if (slot < 0) {
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (change(BUFFER, state.buffers[slot] != buffer)) {
+        glBindBuffer(target, buffer);
+        state.buffers[slot] = buffer;
+    }
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    int slot = textureSlot(target);
+    if (slot < 0 || unit >= static_cast<GLuint>(MAX_TEXTURE_UNITS)) {
+        selectUnit(unit);
+        glBindTexture(target, texture);
+        return;
+    }
+    if (change(TEXTURE, state.textures[unit][slot] != texture)) {
+        selectUnit(unit);
+        glBindTexture(target, texture);
+        state.textures[unit][slot] = texture;
+    }
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled) {
+    int slot = capabilitySlot(capability);
+    int wanted = enabled ? ON : OFF;
+    if (slot >= 0 && !change(CAPABILITY, state.capabilities[slot] != wanted)) {
+        return;
+    }
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+    if (slot >= 0) {
+        state.capabilities[slot] = wanted;
+    }
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (change(BLEND_FUNC, state.blendSource != source || state.blendDestination != destination)) {
+        glBlendFunc(source, destination);
+        state.blendSource = source;
+        state.blendDestination = destination;
+    }
+}
+
+void GLState::depthFunc(GLenum function) {
+    if (change(DEPTH, state.depthFunction != function)) {
+        glDepthFunc(function);
+        state.depthFunction = function;
+    }
+}
+
+void GLState::depthMask(bool enabled) {
+    int wanted = enabled ? ON : OFF;
+    if (change(DEPTH, state.depthWrite != wanted)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        state.depthWrite = wanted;
+    }
+}
+
+void GLState::colorMask(bool enabled) {
+    int wanted = enabled ? ON : OFF;
+    if (change(COLOR_MASK, state.colorWrite != wanted)) {
+        GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+        glColorMask(mask, mask, mask, mask);
+        state.colorWrite = wanted;
+    }
+}
+
+void GLState::deleteProgram(GLuint program) {
+    glDeleteProgram(program);
+    // a deleted program stays in use until another one is installed, so
+    // the shadow is still right; only forget it in case the name is reused
+    if (state.program == program) {
+        state.program = UNKNOWN;
+    }
+}
+
+void GLState::deleteVertexArrays(GLsizei count, const GLuint *vertexArrays) {
+    glDeleteVertexArrays(count, vertexArrays);
+    for (GLsizei i = 0; i < count; i++) {
+        if (vertexArrays[i] != 0 && state.vertexArray == vertexArrays[i]) {
+            state.vertexArray = 0;
+        }
+    }
+}
+
+void GLState::deleteBuffers(GLsizei count, const GLuint *buffers) {
+    glDeleteBuffers(count, buffers);
+    for (GLsizei i = 0; i < count; i++) {
+        for (int slot = 0; slot < BUFFER_TARGETS; slot++) {
+            if (buffers[i] != 0 && state.buffers[slot] == buffers[i]) {
+                state.buffers[slot] = 0;
+            }
+        }
+    }
+}
+
+void GLState::deleteTextures(GLsizei count, const GLuint *textures) {
+    glDeleteTextures(count, textures);
+    for (GLsizei i = 0; i < count; i++) {
+        for (int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+            for (int slot = 0; slot < TEXTURE_TARGETS; slot++) {
+                if (textures[i] != 0 && state.textures[unit][slot] == textures[i]) {
+                    state.textures[unit][slot] = 0;
+                }
+            }
+        }
+    }
+}
+
+void GLState::invalidate() {
+    Shadow unknown = makeUnknown();
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        unknown.issued[i] = state.issued[i];
+        unknown.skipped[i] = state.skipped[i];
+    }
+    state = unknown;
+}
+
+unsigned long long GLState::getIssued(Counter counter) {
+    return state.issued[counter];
+}
+
+unsigned long long GLState::getSkipped(Counter counter) {
+    return state.skipped[counter];
+}
+
+void GLState::report() {
+    unsigned long long issued = 0, skipped = 0;
+    std::cout << "GL_STATE::";
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        std::cout << " " << counterNames[i] << " " << state.issued[i] << "/" << state.skipped[i] << ",";
+        issued += state.issued[i];
+        skipped += state.skipped[i];
+    }
+    std::cout << " total " << issued << " issued, " << skipped << " skipped" << std::endl;
+    resetCounters();
+}
+
+void GLState::resetCounters() {
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        state.issued[i] = 0;
+        state.skipped[i] = 0;
+    }
+}
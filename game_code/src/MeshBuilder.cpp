@@ -0,0 +1,386 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "MeshBuilder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#include "GLState.hpp"
+
+namespace {
+
+const int FORSYTH_CACHE_SIZE = 32;
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+float forsythVertexScore(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // the vertices of the last triangle get a fixed score so the
+            // next triangle does not simply reuse the same edge
+            score = 0.75f;
+        } else {
+            float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, 1.5f);
+        }
+    }
+    // favour vertices with few triangles left so they can leave the cache
+    score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+    return score;
+}
+
+// two vectors perpendicular to `direction` and to each other
+void ringBasis(const glm::vec3 &direction, glm::vec3 &first, glm::vec3 &second) {
+    glm::vec3 axis = glm::normalize(direction);
+    glm::vec3 helper = std::abs(axis.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    first = glm::normalize(glm::cross(helper, axis));
+    second = glm::cross(axis, first);
+}
+
+} // namespace
+
+void Mesh::upload() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    GLState::bindVertexArray(VAO);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+    packedVertexFormat().apply();
+
+    GLState::bindVertexArray(0);
+}
+
+// expects the mesh VAO to be bound
+void Mesh::draw(const SubMesh &subMesh) const {
+    glDrawElements(GL_TRIANGLES, subMesh.indexCount, GL_UNSIGNED_INT,
+                   reinterpret_cast<void *>(subMesh.firstIndex * sizeof(GLuint)));
+}
+
+void Mesh::release() {
+    GLState::deleteVertexArrays(1, &VAO);
+    GLState::deleteBuffers(1, &VBO);
+    GLState::deleteBuffers(1, &EBO);
+    VAO = VBO = EBO = 0;
+}
+
+SubMesh MeshBuilder::addQuad(const glm::vec3 corners[4], const glm::vec2 texCoords[4], const glm::vec3 &normal) {
+    SubMesh subMesh = beginSubMesh();
+    GLuint quad[4];
+    for (int i = 0; i < 4; i++) {
+        quad[i] = addVertex(corners[i], texCoords[i], normal);
+    }
+    addTriangle(quad[0], quad[1], quad[2]);
+    addTriangle(quad[2], quad[3], quad[0]);
+    return endSubMesh(subMesh);
+}
+
+SubMesh MeshBuilder::addQuadStrip(const glm::vec3 &startA, const glm::vec3 &startB, const glm::vec3 &endA,
+                                  const glm::vec3 &endB, int segments, const glm::vec2 &texRepeat,
+                                  const glm::vec3 &normal) {
+    SubMesh subMesh = beginSubMesh();
+    GLuint previousA = 0, previousB = 0;
+    for (int i = 0; i <= segments; i++) {
+        float t = static_cast<float>(i) / segments;
+        GLuint a = addVertex(glm::mix(startA, endA, t), glm::vec2(t * texRepeat.x, 0.0f), normal);
+        GLuint b = addVertex(glm::mix(startB, endB, t), glm::vec2(t * texRepeat.x, texRepeat.y), normal);
+        if (i > 0) {
+            addTriangle(previousA, previousB, b);
+            addTriangle(previousA, b, a);
+        }
+        previousA = a;
+        previousB = b;
+    }
+    return endSubMesh(subMesh);
+}
+
+SubMesh MeshBuilder::addCylinder(const glm::vec3 &base, const glm::vec3 &axis, float radius, int segments,
+                                 const glm::vec2 &texRepeat) {
+    SubMesh subMesh = beginSubMesh();
+    glm::vec3 first, second;
+    ringBasis(axis, first, second);
+
+    GLuint previousBottom = 0, previousTop = 0;
+    for (int i = 0; i <= segments; i++) {
+        float u = static_cast<float>(i) / segments;
+        float angle = 2.0f * static_cast<float>(M_PI) * u;
+        glm::vec3 normal = std::cos(angle) * first + std::sin(angle) * second;
+        glm::vec3 bottom = base + radius * normal;
+
+        GLuint bottomIndex = addVertex(bottom, glm::vec2(u * texRepeat.x, 0.0f), normal);
+        GLuint topIndex = addVertex(bottom + axis, glm::vec2(u * texRepeat.x, texRepeat.y), normal);
+        if (i > 0) {
+            addTriangle(previousBottom, bottomIndex, topIndex);
+            addTriangle(previousBottom, topIndex, previousTop);
+        }
+        previousBottom = bottomIndex;
+        previousTop = topIndex;
+    }
+    return endSubMesh(subMesh);
+}
+
+SubMesh MeshBuilder::addCap(const glm::vec3 &center, const glm::vec3 &normal, float radius, int segments) {
+    SubMesh subMesh = beginSubMesh();
+    glm::vec3 first, second;
+    ringBasis(normal, first, second);
+
+    GLuint centerIndex = addVertex(center, glm::vec2(0.5f, 0.5f), normal);
+    GLuint previous = 0;
+    for (int i = 0; i <= segments; i++) {
+        float angle = 2.0f * static_cast<float>(M_PI) * i / segments;
+        float c = std::cos(angle), s = std::sin(angle);
+        GLuint rim = addVertex(center + radius * (c * first + s * second), glm::vec2(0.5f + 0.5f * c, 0.5f + 0.5f * s),
+                               normal);
+        if (i > 0) {
+            addTriangle(centerIndex, previous, rim);
+        }
+        previous = rim;
+    }
+    return endSubMesh(subMesh);
+}
+
+SubMesh MeshBuilder::addSphere(const glm::vec3 &center, float radius, int sectors, int stacks) {
+    SubMesh subMesh = beginSubMesh();
+    std::vector<GLuint> grid;
+    for (int i = 0; i <= stacks; ++i) {
+        float stackAngle = static_cast<float>(M_PI / 2 - i * M_PI / stacks); //phi
+        float xy = std::cos(stackAngle);
+        float z = std::sin(stackAngle);
+
+        for (int j = 0; j <= sectors; ++j) {
+            float sectorAngle = static_cast<float>(j * 2 * M_PI / sectors); //theta
+            glm::vec3 normal(xy * std::cos(sectorAngle), xy * std::sin(sectorAngle), z);
+            glm::vec2 texCoord(static_cast<float>(j) / sectors, static_cast<float>(i) / stacks);
+            grid.push_back(addVertex(center + radius * normal, texCoord, normal));
+        }
+    }
+
+    // the first and last stack are fans around the poles
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < sectors; ++j) {
+            GLuint k1 = grid[i * (sectors + 1) + j];
+            GLuint k2 = grid[(i + 1) * (sectors + 1) + j];
+            GLuint k1Next = grid[i * (sectors + 1) + j + 1];
+            GLuint k2Next = grid[(i + 1) * (sectors + 1) + j + 1];
+            if (i != 0) {
+                addTriangle(k1, k2, k1Next);
+            }
+            if (i != stacks - 1) {
+                addTriangle(k1Next, k2, k2Next);
+            }
+        }
+    }
+    return endSubMesh(subMesh);
+}
+
+MeshStats MeshBuilder::optimize() {
+    MeshStats stats;
+    stats.acmrBefore = acmr(indices, 0, indices.size());
+    for (const SubMesh &subMesh : subMeshes) {
+        optimizeTriangles(subMesh.firstIndex, subMesh.indexCount);
+    }
+    optimizeFetch();
+    stats.acmrAfter = acmr(indices, 0, indices.size());
+    return stats;
+}
+
+Mesh MeshBuilder::build() const {
+    Mesh mesh;
+    mesh.vertices = vertices;
+    mesh.indices = indices;
+    return mesh;
+}
+
+// FIFO post-transform cache model, misses per triangle
+float MeshBuilder::acmr(const std::vector<GLuint> &indices, std::size_t first, std::size_t count,
+                        std::size_t cacheSize) {
+    if (count < 3) {
+        return 0.0f;
+    }
+    std::deque<GLuint> cache;
+    std::size_t misses = 0;
+    for (std::size_t i = first; i < first + count; i++) {
+        if (std::find(cache.begin(), cache.end(), indices[i]) == cache.end()) {
+            misses++;
+            cache.push_back(indices[i]);
+            if (cache.size() > cacheSize) {
+                cache.pop_front();
+            }
+        }
+    }
+    return static_cast<float>(misses) / (count / 3);
+}
+
+GLuint MeshBuilder::addVertex(const glm::vec3 &position, const glm::vec2 &texCoord, const glm::vec3 &normal) {
+    PackedVertex vertex = packVertex(position, texCoord, normal);
+
+    static_assert(sizeof(PackedVertex) == sizeof(VertexKey), "vertex key must cover the whole packed vertex");
+    VertexKey key;
+    std::memcpy(&key, &vertex, sizeof(key));
+
+    std::unordered_map<VertexKey, GLuint, VertexKeyHash>::const_iterator found = vertexLookup.find(key);
+    if (found != vertexLookup.end()) {
+        return found->second;
+    }
+    GLuint index = static_cast<GLuint>(vertices.size());
+    vertices.push_back(vertex);
+    vertexLookup[key] = index;
+    return index;
+}
+
+void MeshBuilder::addTriangle(GLuint a, GLuint b, GLuint c) {
+    // quantization can collapse thin triangles, those would only cost setup
+    if (a == b || b == c || a == c) {
+        return;
+    }
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+SubMesh MeshBuilder::beginSubMesh() const {
+    SubMesh subMesh = {static_cast<GLuint>(indices.size()), 0};
+    return subMesh;
+}
+
+SubMesh MeshBuilder::endSubMesh(SubMesh subMesh) {
+    subMesh.indexCount = static_cast<GLsizei>(indices.size() - subMesh.firstIndex);
+    subMeshes.push_back(subMesh);
+    return subMesh;
+}
+
+void MeshBuilder::optimizeTriangles(std::size_t first, std::size_t count) {
+    std::size_t triangleCount = count / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+    const GLuint *triangles = &indices[first];
+    std::size_t vertexCount = vertices.size();
+
+    // triangles that still have to be emitted, per vertex
+    std::vector<int> remaining(vertexCount, 0);
+    for (std::size_t i = 0; i < count; i++) {
+        remaining[triangles[i]]++;
+    }
+    std::vector<int> offsets(vertexCount + 1, 0);
+    for (std::size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<int> adjacency(count);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[triangles[3 * t + k]]++] = static_cast<int>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    for (std::size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[triangles[3 * t]] + vertexScore[triangles[3 * t + 1]] +
+                           vertexScore[triangles[3 * t + 2]];
+    }
+
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<GLuint> output;
+    output.reserve(count);
+    std::vector<GLuint> cache, nextCache;
+    std::size_t scanStart = 0;
+    int best = static_cast<int>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+
+    while (output.size() < count) {
+        if (best < 0) {
+            // nothing left next to the cache, continue with a fresh triangle
+            while (emitted[scanStart]) {
+                scanStart++;
+            }
+            best = static_cast<int>(scanStart);
+        }
+        emitted[best] = 1;
+
+        nextCache.clear();
+        for (int k = 0; k < 3; k++) {
+            GLuint v = triangles[3 * best + k];
+            output.push_back(v);
+            nextCache.push_back(v);
+
+            int *begin = &adjacency[offsets[v]];
+            int *end = begin + remaining[v];
+            std::iter_swap(std::find(begin, end, best), end - 1);
+            remaining[v]--;
+        }
+        for (GLuint v : cache) {
+            if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2]) {
+                nextCache.push_back(v);
+            }
+        }
+
+        // vertices pushed out of the cache and the ones inside need new scores
+        for (std::size_t i = 0; i < nextCache.size(); i++) {
+            GLuint v = nextCache[i];
+            cachePosition[v] = i < static_cast<std::size_t>(FORSYTH_CACHE_SIZE) ? static_cast<int>(i) : -1;
+            vertexScore[v] = forsythVertexScore(cachePosition[v], remaining[v]);
+        }
+        for (GLuint v : nextCache) {
+            for (int a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                int t = adjacency[a];
+                triangleScore[t] = vertexScore[triangles[3 * t]] + vertexScore[triangles[3 * t + 1]] +
+                                   vertexScore[triangles[3 * t + 2]];
+            }
+        }
+        if (nextCache.size() > static_cast<std::size_t>(FORSYTH_CACHE_SIZE)) {
+            nextCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (GLuint v : cache) {
+            for (int a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                int t = adjacency[a];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+    std::copy(output.begin(), output.end(), indices.begin() + first);
+}
+
+void MeshBuilder::optimizeFetch() {
+    // number vertices in the order they are first referenced
+    std::vector<GLuint> remap(vertices.size(), static_cast<GLuint>(-1));
+    std::vector<PackedVertex> reordered;
+    reordered.reserve(vertices.size());
+    for (GLuint &index : indices) {
+        if (remap[index] == static_cast<GLuint>(-1)) {
+            remap[index] = static_cast<GLuint>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+
+    vertexLookup.clear();
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+        VertexKey key;
+        std::memcpy(&key, &vertices[i], sizeof(key));
+        vertexLookup[key] = static_cast<GLuint>(i);
+    }
+}
@@ -0,0 +1,39 @@
+#include "ObstacleStore.hpp"
+
+#include "AABB_CollisionDetection.hpp"
+
+ObstacleStore::ObstacleStore(int capacity)
+        : BoxRing(capacity),
+          kindColumn(this->capacity()), laneColumn(this->capacity()), xColumn(this->capacity()),
+          zColumn(this->capacity()) {}
+
+bool ObstacleStore::push(ObstacleKind kind, int lane, const glm::vec3 &position) {
+    CollisionDetector box;
+    box.getObstacle(position, kind);
+    int slot = pushBox(box.getMin(), box.getMax());
+    if (slot < 0) {
+        return false;
+    }
+
+    kindColumn[slot] = kind;
+    laneColumn[slot] = lane;
+    xColumn[slot] = position.x;
+    zColumn[slot] = position.z;
+    return true;
+}
+
+const ObstacleKind *ObstacleStore::kinds() const {
+    return kindColumn.data();
+}
+
+const int *ObstacleStore::lanes() const {
+    return laneColumn.data();
+}
+
+const float *ObstacleStore::positionX() const {
+    return xColumn.data();
+}
+
+const float *ObstacleStore::positionZ() const {
+    return zColumn.data();
+}
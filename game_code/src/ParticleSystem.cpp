@@ -0,0 +1,148 @@
+#include "ParticleSystem.hpp"
+
+#include <algorithm>
+
+#include "GLState.hpp"
+#include "VertexFormat.hpp"
+
+namespace {
+
+const std::string shader_location("../res/shaders/");
+
+} // namespace
+
+ParticleSystem::ParticleSystem(int capacity, float groundLevel)
+        : capacity(capacity), groundLevel(groundLevel),
+          updateShader(shader_location + "particle_update.vert",
+                       std::vector<std::string>{"outPositionAge", "outVelocityLife", "outKind"}),
+          drawShader(shader_location + "particle.vert", shader_location + "particle.frag") {
+    // every slot starts out dead: age 1, lifetime 0
+    Particle dead = {glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f), 0.0f};
+    std::vector<Particle> initial(capacity, dead);
+
+    VertexFormat particleFormat(sizeof(Particle));
+    particleFormat.add(0, 4, GL_FLOAT, GL_FALSE, offsetof(Particle, positionAge))
+                  .add(1, 4, GL_FLOAT, GL_FALSE, offsetof(Particle, velocityLife))
+                  .add(2, 1, GL_FLOAT, GL_FALSE, offsetof(Particle, kind));
+    VertexFormat instanceFormat(sizeof(Particle));
+    instanceFormat.add(1, 4, GL_FLOAT, GL_FALSE, offsetof(Particle, positionAge))
+                  .add(2, 4, GL_FLOAT, GL_FALSE, offsetof(Particle, velocityLife))
+                  .add(3, 1, GL_FLOAT, GL_FALSE, offsetof(Particle, kind));
+
+    const float corners[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    glGenBuffers(1, &quadVBO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+    glGenBuffers(2, buffers);
+    glGenVertexArrays(2, updateVAO);
+    glGenVertexArrays(2, drawVAO);
+    for (int i = 0; i < 2; i++) {
+        GLState::bindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(initial.size() * sizeof(Particle)), initial.data(),
+                     GL_DYNAMIC_COPY);
+
+        GLState::bindVertexArray(updateVAO[i]);
+        particleFormat.apply();
+
+        GLState::bindVertexArray(drawVAO[i]);
+        instanceFormat.apply();
+        for (GLuint location = 1; location <= 3; location++) {
+            glVertexAttribDivisor(location, 1);
+        }
+        GLState::bindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        VertexFormat(2 * sizeof(float)).add(0, 2, GL_FLOAT, GL_FALSE, 0).apply();
+    }
+    GLState::bindVertexArray(0);
+
+    drawShader.use();
+    drawShader.setVec3("fogColor", glm::vec3(0.5f, 0.5f, 0.5f));
+    drawShader.setFloat("fogStart", 4.0f);
+    drawShader.setFloat("fogEnd", 13.0f);
+}
+
+void ParticleSystem::update(const std::vector<ParticleEmission> &emissions, float dt) {
+    GLint starts[MAX_EMITTERS], counts[MAX_EMITTERS];
+    GLfloat origins[MAX_EMITTERS * 3], velocities[MAX_EMITTERS * 3], spreads[MAX_EMITTERS * 3];
+    GLfloat radii[MAX_EMITTERS], lives[MAX_EMITTERS], kinds[MAX_EMITTERS];
+    int emitters = 0;
+
+    for (const ParticleEmission &emission : emissions) {
+        int remaining = std::min(emission.count, capacity);
+        // a range crossing the end of the ring is split in two
+        while (remaining > 0 && emitters < MAX_EMITTERS) {
+            int count = std::min(remaining, capacity - cursor);
+            starts[emitters] = cursor;
+            counts[emitters] = count;
+            for (int c = 0; c < 3; c++) {
+                origins[emitters * 3 + c] = emission.origin[c];
+                velocities[emitters * 3 + c] = emission.velocity[c];
+                spreads[emitters * 3 + c] = emission.spread[c];
+            }
+            radii[emitters] = emission.radius;
+            lives[emitters] = emission.life;
+            kinds[emitters] = static_cast<GLfloat>(emission.kind);
+            emitters++;
+
+            cursor = (cursor + count) % capacity;
+            remaining -= count;
+        }
+    }
+
+    updateShader.use();
+    glUniform1i(glGetUniformLocation(updateShader.ID, "emitterCount"), emitters);
+    if (emitters > 0) {
+        glUniform1iv(glGetUniformLocation(updateShader.ID, "emitStart"), emitters, starts);
+        glUniform1iv(glGetUniformLocation(updateShader.ID, "emitCount"), emitters, counts);
+        glUniform3fv(glGetUniformLocation(updateShader.ID, "emitOrigin"), emitters, origins);
+        glUniform3fv(glGetUniformLocation(updateShader.ID, "emitVelocity"), emitters, velocities);
+        glUniform3fv(glGetUniformLocation(updateShader.ID, "emitSpread"), emitters, spreads);
+        glUniform1fv(glGetUniformLocation(updateShader.ID, "emitRadius"), emitters, radii);
+        glUniform1fv(glGetUniformLocation(updateShader.ID, "emitLife"), emitters, lives);
+        glUniform1fv(glGetUniformLocation(updateShader.ID, "emitKind"), emitters, kinds);
+    }
+    glUniform1ui(glGetUniformLocation(updateShader.ID, "seed"), 0x9e3779b9u * ++frame);
+    updateShader.setFloat("dt", dt);
+    updateShader.setFloat("groundLevel", groundLevel);
+    updateShader.setVec3("gravity", gravity);
+    updateShader.setFloat("drag", drag);
+
+    int target = 1 - current;
+    GLState::setEnabled(GL_RASTERIZER_DISCARD, true);
+    GLState::bindVertexArray(updateVAO[current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[target]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, capacity);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    GLState::setEnabled(GL_RASTERIZER_DISCARD, false);
+    current = target;
+}
+
+void ParticleSystem::draw(const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &cameraPosition) {
+    drawShader.use();
+    drawShader.setMat4("view", view);
+    drawShader.setMat4("projection", projection);
+    drawShader.setVec3("cameraPos", cameraPosition);
+
+    GLState::setEnabled(GL_BLEND, true);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::depthMask(false);
+    GLState::bindVertexArray(drawVAO[current]);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, capacity);
+    GLState::depthMask(true);
+    GLState::setEnabled(GL_BLEND, false);
+}
+
+void ParticleSystem::release() {
+    GLState::deleteVertexArrays(2, updateVAO);
+    GLState::deleteVertexArrays(2, drawVAO);
+    GLState::deleteBuffers(2, buffers);
+    GLState::deleteBuffers(1, &quadVBO);
+    GLState::deleteProgram(updateShader.ID);
+    GLState::deleteProgram(drawShader.ID);
+}
+
+int ParticleSystem::getCapacity() const {
+    return capacity;
+}
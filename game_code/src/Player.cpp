@@ -1,54 +1,67 @@
-#include <iostream>
-#include <cmath>
+#include <algorithm>
 #include "Player.hpp"
 
+namespace {
+
+// every action takes scale / speed seconds; with the game's speeds a lane
+// switch takes 0.5 s, a jump 1.33 s and a crouch 0.93 s
+const float LANE_SWITCH_SCALE = 3.75f;
+const float JUMP_SCALE = 4.0f;
+const float CROUCH_SCALE = 2.8f;
+
+// fraction of an action started at start that is done at time
+float progress(float time, float start, float duration) {
+    return std::min(std::max((time - start) / duration, 0.0f), 1.0f);
+}
+
+// 0 to 1 with zero slope at both ends
+float easeInOut(float u) {
+    return u * u * (3.0f - 2.0f * u);
+}
+
+// 0 at both ends, 1 half way, a jump under constant gravity
+float parabola(float u) {
+    return 4.0f * u * (1.0f - u);
+}
+
+} // namespace
+
 Player::Player(const std::vector<float>& lanes, int startLaneIndex, float switchSpeed, float jumpSpeed, float crouchSpeed)
-        : lanes(lanes), currentLaneIndex(startLaneIndex), laneSwitchSpeed(switchSpeed), position(glm::vec3(lanes[startLaneIndex], 0.0f, 0.0f)), jumpSpeed(jumpSpeed), crouchSpeed(crouchSpeed) {}
+        : lanes(lanes), currentLaneIndex(startLaneIndex), targetLaneIndex(startLaneIndex),
+          position(glm::vec3(lanes[startLaneIndex], 0.0f, 0.0f)), laneSwitchTime(LANE_SWITCH_SCALE / switchSpeed),
+          jumpTime(JUMP_SCALE / jumpSpeed), crouchTime(CROUCH_SCALE / crouchSpeed) {}
 
+// An action pressed now starts at the beginning of the step, so the step
+// that sees the key press already moves. Actions are not interrupted: a
+// lane switch runs to its lane, a jump or crouch back to the ground.
 void Player::ProcessInput(bool leftKeyPressed, bool rightKeyPressed, bool upKeyPressed, bool downKeyPressed, float deltaTime) {
-    if (leftKeyPressed && currentLaneIndex > 0 && !goingRight)
-    { goingLeft = true;}
-    if (rightKeyPressed && currentLaneIndex < lanes.size() - 1 && !goingLeft)
-    { goingRight = true;}
-    if(goingLeft && !goingRight) {
-        float targetX = lanes[currentLaneIndex - 1];
-        position.x = glm::mix(position.x, targetX, laneSwitchSpeed * deltaTime);
-        if (abs(position.x - targetX) <= 0.01f){
-            goingLeft = false;
-            currentLaneIndex--;
+    if (targetLaneIndex == currentLaneIndex) {
+        if (leftKeyPressed && currentLaneIndex > 0) {
+            targetLaneIndex = currentLaneIndex - 1;
+            laneStart = clock;
+        } else if (rightKeyPressed && currentLaneIndex + 1 < static_cast<int>(lanes.size())) {
+            targetLaneIndex = currentLaneIndex + 1;
+            laneStart = clock;
         }
     }
-    if(goingRight && !goingLeft) {
-        float targetX = lanes[currentLaneIndex + 1];
-        position.x = glm::mix(position.x, targetX, laneSwitchSpeed * deltaTime);
-        if (abs(position.x - targetX) <= 0.01f){
-            goingRight = false;
-            currentLaneIndex++;
+    if (vertical == VERTICAL_NONE) {
+        if (upKeyPressed) {
+            vertical = VERTICAL_JUMP;
+            verticalStart = clock;
+        } else if (downKeyPressed) {
+            vertical = VERTICAL_CROUCH;
+            verticalStart = clock;
         }
     }
-    if (upKeyPressed && !isCrouching && !isGrounding)
-    { isJumping = true; }
 
-    if(isJumping) {
-        position.y = glm::mix(position.y, targetJump, jumpSpeed * deltaTime);
-        if (abs(position.y - targetJump) <= 0.08f){
-            isJumping = false; isGrounding = true;
-        }
-    }
-    if(isGrounding) {
-        position.y = glm::mix(position.y, 0.0f, jumpSpeed * deltaTime);
-        if (abs(position.y) <= 0.05f){
-            isGrounding = false;
-        }
+    clock += deltaTime;
+    position.x = laneX(clock);
+    position.y = height(clock);
+    if (targetLaneIndex != currentLaneIndex && clock - laneStart >= laneSwitchTime) {
+        currentLaneIndex = targetLaneIndex;
     }
-    if(downKeyPressed && !isJumping && !isGrounding){
-        isCrouching = true;
-    }
-    if(isCrouching) {
-        position.y = glm::mix(position.y, targetCrouch, crouchSpeed * deltaTime);
-        if (abs(position.y - targetCrouch) <= 0.08f) {
-            isCrouching = false; isGrounding = true;
-        }
+    if (vertical != VERTICAL_NONE && clock - verticalStart >= verticalDuration()) {
+        vertical = VERTICAL_NONE;
     }
 }
 
@@ -56,10 +69,51 @@ glm::vec3 Player::GetPosition() const {
     return position;
 }
 
+glm::vec3 Player::GetPositionAt(float time) const {
+    return glm::vec3(laneX(time), height(time), position.z - forwardSpeed * (time - clock));
+}
+
+float Player::getTime() const {
+    return clock;
+}
+
+float Player::getRestTime() const {
+    float rest = clock;
+    if (targetLaneIndex != currentLaneIndex) {
+        rest = std::max(rest, laneStart + laneSwitchTime);
+    }
+    if (vertical != VERTICAL_NONE) {
+        rest = std::max(rest, verticalStart + verticalDuration());
+    }
+    return rest;
+}
+
 void Player::MoveForward(float speed, float deltaTime) {
+    forwardSpeed = speed;
     position.z -= speed * deltaTime;
 }
 
 int Player::getCurrentLane() {
     return currentLaneIndex;
 }
+
+float Player::laneX(float time) const {
+    float from = lanes[currentLaneIndex];
+    float to = lanes[targetLaneIndex];
+    return from + (to - from) * easeInOut(progress(time, laneStart, laneSwitchTime));
+}
+
+float Player::height(float time) const {
+    switch (vertical) {
+    case VERTICAL_JUMP:
+        return jumpHeight * parabola(progress(time, verticalStart, jumpTime));
+    case VERTICAL_CROUCH:
+        return -crouchDepth * parabola(progress(time, verticalStart, crouchTime));
+    default:
+        return 0.0f;
+    }
+}
+
+float Player::verticalDuration() const {
+    return vertical == VERTICAL_CROUCH ? crouchTime : jumpTime;
+}
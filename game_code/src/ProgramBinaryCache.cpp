@@ -0,0 +1,146 @@
+#include <ProgramBinaryCache.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const std::uint32_t CACHE_MAGIC = 0x31434250; // "PBC1"
+
+// 64-bit FNV-1a, only used to name the cache entries
+std::uint64_t hashString(const std::string &text) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string glString(GLenum name) {
+  const GLubyte *value = glGetString(name);
+  return value ? reinterpret_cast<const char *>(value) : "";
+}
+
+void makeDirectory(const std::string &dir) {
+#ifdef _WIN32
+  _mkdir(dir.c_str());
+#else
+  mkdir(dir.c_str(), 0755);
+#endif
+}
+
+template <typename T> bool readValue(std::ifstream &file, T &value) {
+  return static_cast<bool>(
+      file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> void writeValue(std::ofstream &file, const T &value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+} // namespace
+
+std::string ProgramBinaryCache::directory("../shader_cache/");
+
+void ProgramBinaryCache::setDirectory(const std::string &dir) {
+  directory = dir;
+  if (!directory.empty() && directory.back() != '/')
+    directory += '/';
+}
+
+bool ProgramBinaryCache::isSupported() {
+  if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary)
+    return false;
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+bool ProgramBinaryCache::load(GLuint program, const std::string &source) {
+  if (!isSupported())
+    return false;
+
+  std::ifstream file(entryPath(source), std::ios::binary);
+  if (!file)
+    return false;
+
+  std::uint32_t magic = 0, signatureLength = 0;
+  if (!readValue(file, magic) || magic != CACHE_MAGIC ||
+      !readValue(file, signatureLength))
+    return false;
+
+  // entries written by another driver are stale, the next store replaces them
+  std::string signature(signatureLength, '\0');
+  if (!file.read(&signature[0], signatureLength) ||
+      signature != driverSignature())
+    return false;
+
+  std::uint32_t format = 0, length = 0;
+  if (!readValue(file, format) || !readValue(file, length) || length == 0)
+    return false;
+
+  std::vector<char> binary(length);
+  if (!file.read(binary.data(), length))
+    return false;
+
+  glProgramBinary(program, format, binary.data(),
+                  static_cast<GLsizei>(length));
+
+  // the driver is free to reject a binary it produced itself
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success == GL_TRUE;
+}
+
+void ProgramBinaryCache::store(GLuint program, const std::string &source) {
+  if (!isSupported())
+    return;
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  GLenum format = 0;
+  glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+  makeDirectory(directory);
+  std::ofstream file(entryPath(source), std::ios::binary | std::ios::trunc);
+  if (!file) {
+    std::cout << "WARNING::PROGRAM_BINARY_CACHE::CANNOT_WRITE " << directory
+              << std::endl;
+    return;
+  }
+
+  std::string signature = driverSignature();
+  writeValue(file, CACHE_MAGIC);
+  writeValue(file, static_cast<std::uint32_t>(signature.size()));
+  file.write(signature.data(), signature.size());
+  writeValue(file, static_cast<std::uint32_t>(format));
+  writeValue(file, static_cast<std::uint32_t>(length));
+  file.write(binary.data(), length);
+}
+
+std::string ProgramBinaryCache::entryPath(const std::string &source) {
+  std::ostringstream name;
+  name << directory << std::hex << std::setw(16) << std::setfill('0')
+       << hashString(source) << ".bin";
+  return name.str();
+}
+
+std::string ProgramBinaryCache::driverSignature() {
+  return glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' +
+         glString(GL_VERSION);
+}
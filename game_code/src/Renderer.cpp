@@ -0,0 +1,488 @@
+#include <OpenGLPrj.hpp>
+
+#include "Renderer.hpp"
+
+#include "GLState.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const std::string shader_location("../res/shaders/");
+
+void reportMeshStats(const char *name, const MeshStats &stats) {
+    std::cout << "MESH::" << name << " ACMR " << std::fixed << std::setprecision(3) << stats.acmrBefore
+              << " -> " << stats.acmrAfter << std::defaultfloat << std::endl;
+}
+
+GLuint loadTexture(const char* path) {
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    GLState::bindTexture(0, GL_TEXTURE_2D, textureID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    int width, height, nrChannels;
+    unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 0);
+    if (data) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    } else {
+        std::cout << "Failed to load texture: " << path << std::endl;
+    }
+    stbi_image_free(data);
+    return textureID;
+}
+
+int index(MeshId id) {
+    return static_cast<int>(id);
+}
+
+int index(TextureId id) {
+    return static_cast<int>(id);
+}
+
+} // namespace
+
+// the 3D scene may use 80% of a 60 Hz frame on the GPU, the rest is left
+// for the upscale, the HUD and the driver
+Renderer::Renderer(float groundLevel, float segmentLength, int coinCapacity, int framebufferWidth,
+                   int framebufferHeight, SwapMode swapMode, double frameCap)
+        : sceneShader(shader_location + "shader.vert", shader_location + "shader.frag"),
+          textShader(shader_location + "text.vert", shader_location + "text.frag"),
+          overdrawShader(shader_location + "overdraw.vert", shader_location + "overdraw.frag"),
+          particles(131072, groundLevel), coins(coinCapacity),
+          dynamicResolution(framebufferWidth, framebufferHeight, 0.8f * 1000.0f / 60.0f),
+          framePacer(swapMode, frameCap), appliedSwapMode(swapMode) {
+    // configure global opengl state
+    // -----------------------------
+    GLState::setEnabled(GL_DEPTH_TEST, true);
+    GLState::setEnabled(GL_CULL_FACE, true);
+    GLState::setEnabled(GL_BLEND, true);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    if (!loadFont("../res/fonts/arial.ttf")) {
+        ready = false;
+    }
+
+    glGenVertexArrays(1, &textVAO);
+    glGenBuffers(1, &textVBO);
+    GLState::bindVertexArray(textVAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, textVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    GLState::bindVertexArray(0);
+
+    buildMeshes(groundLevel, segmentLength);
+
+    textures[index(TextureId::PATH)] = loadTexture("../res/textures/mud_forest_diff_4k_scaled.jpg");
+    textures[index(TextureId::WALL)] = loadTexture("../res/textures/mossy_cobblestone_diff_4k_scaled.jpg");
+    textures[index(TextureId::TRUNK)] = loadTexture("../res/textures/bark_willow_diff_4k.jpg");
+    textures[index(TextureId::CIRCLE_TRUNK)] = loadTexture("../res/textures/round_tree.jpg");
+    textures[index(TextureId::FALLEN_TRUNK)] = loadTexture("../res/textures/tree_fallen.jpg");
+    textures[index(TextureId::BALL)] = loadTexture("../res/textures/rock_ball_scaled.jpg");
+
+    sceneShader.use();
+
+    // Set fog uniforms
+    sceneShader.setVec3("fogColor", glm::vec3(0.5f, 0.5f, 0.5f));
+    sceneShader.setFloat("fogStart", 4.0f);
+    sceneShader.setFloat("fogEnd", 13.0f);
+    sceneShader.setInt("diffuseTexture", 0);
+
+    sceneShader.setInt("lightData", TiledLighting::FIRST_TEXTURE_UNIT);
+    sceneShader.setInt("tileLights", TiledLighting::FIRST_TEXTURE_UNIT + 1);
+    sceneShader.setInt("lightIndices", TiledLighting::FIRST_TEXTURE_UNIT + 2);
+    sceneShader.setVec3("ambientLight", glm::vec3(0.5f, 0.5f, 0.55f));
+
+    glGenQueries(1, &overdrawQuery);
+}
+
+bool Renderer::isReady() const {
+    return ready;
+}
+
+bool Renderer::loadFont(const char *path) {
+    FT_Library ft;
+    // All functions return a value different than 0 whenever an error occurred
+    if (FT_Init_FreeType(&ft))
+    {
+        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        return false;
+    }
+
+    FT_Face face;
+    if (FT_New_Face(ft, path, 0, &face)) {
+        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(ft);
+        return false;
+    }
+
+    // set size to load glyphs as
+    FT_Set_Pixel_Sizes(face, 0, 48);
+
+    // disable byte-alignment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // load first 128 characters of ASCII set
+    for (unsigned char c = 0; c < 128; c++)
+    {
+        // Load character glyph
+        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+        {
+            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            continue;
+        }
+        // generate texture
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+        glTexImage2D(
+                GL_TEXTURE_2D,
+                0,
+                GL_RED,
+                face->glyph->bitmap.width,
+                face->glyph->bitmap.rows,
+                0,
+                GL_RED,
+                GL_UNSIGNED_BYTE,
+                face->glyph->bitmap.buffer
+        );
+        // set texture options
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // now store character for later use
+        Character character = {
+                texture,
+                glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+                glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+                static_cast<unsigned int>(face->glyph->advance.x)
+        };
+        characters.insert(std::pair<char, Character>(c, character));
+    }
+    GLState::bindTexture(0, GL_TEXTURE_2D, 0);
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+    return true;
+}
+
+void Renderer::buildMeshes(float groundLevel, float segmentLength) {
+    // a single path and wall segment in local space, spanning z = 0 to
+    // z = -segmentLength; each segment is drawn translated to its own start
+    glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+    MeshBuilder pathBuilder;
+    subMeshes[index(MeshId::PATH_SEGMENT)] = pathBuilder.addQuadStrip(
+            glm::vec3(-0.7f, groundLevel, 0.0f), glm::vec3(0.7f, groundLevel, 0.0f),
+            glm::vec3(-0.7f, groundLevel, -segmentLength), glm::vec3(0.7f, groundLevel, -segmentLength),
+            1, glm::vec2(1.0f, 1.0f), up);
+    reportMeshStats("path", pathBuilder.optimize());
+    pathMesh = pathBuilder.build();
+    pathMesh.upload();
+    meshes[index(MeshId::PATH_SEGMENT)] = &pathMesh;
+
+    MeshBuilder wallBuilder;
+    //left wall
+    SubMesh leftWall = wallBuilder.addQuadStrip(
+            glm::vec3(-0.7f, groundLevel, 0.0f), glm::vec3(-0.7f, 5.0f, 0.0f),
+            glm::vec3(-0.7f, groundLevel, -segmentLength), glm::vec3(-0.7f, 5.0f, -segmentLength),
+            1, glm::vec2(1.0f, 5.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    //right wall
+    SubMesh rightWall = wallBuilder.addQuadStrip(
+            glm::vec3(0.7f, groundLevel, 0.0f), glm::vec3(0.7f, 5.0f, 0.0f),
+            glm::vec3(0.7f, groundLevel, -segmentLength), glm::vec3(0.7f, 5.0f, -segmentLength),
+            1, glm::vec2(1.0f, 5.0f), glm::vec3(-1.0f, 0.0f, 0.0f));
+    // both walls share a material and are adjacent in the index buffer
+    SubMesh wallSegment = {leftWall.firstIndex, leftWall.indexCount + rightWall.indexCount};
+    subMeshes[index(MeshId::WALL_SEGMENT)] = wallSegment;
+    reportMeshStats("walls", wallBuilder.optimize());
+    wallMesh = wallBuilder.build();
+    wallMesh.upload();
+    meshes[index(MeshId::WALL_SEGMENT)] = &wallMesh;
+
+    const int sectorCount = 72; //horizontal slices
+    const int stackCount = sectorCount / 2; //vertical slices
+    const float radius = 0.1f;
+
+    MeshBuilder ballBuilder;
+    subMeshes[index(MeshId::BALL)] = ballBuilder.addSphere(glm::vec3(0.0f), radius, sectorCount, stackCount);
+    reportMeshStats("ball", ballBuilder.optimize());
+    ballMesh = ballBuilder.build();
+    ballMesh.upload();
+    meshes[index(MeshId::BALL)] = &ballMesh;
+
+    //tree trunks
+    int n = 130;
+    float r = 0.1f;
+    float topyc = 0.2f;
+
+    MeshBuilder obstacleBuilder;
+    subMeshes[index(MeshId::TRUNK_TOP)] = obstacleBuilder.addCap(glm::vec3(0.0f, topyc, 0.0f), up, r, n);
+    subMeshes[index(MeshId::TRUNK_SIDE)] = obstacleBuilder.addCylinder(
+            glm::vec3(0.0f, groundLevel, 0.0f), glm::vec3(0.0f, topyc - groundLevel, 0.0f), r, n,
+            glm::vec2(1.0f, 1.0f));
+    //down fallen trunk
+    subMeshes[index(MeshId::DOWN_TRUNK)] = obstacleBuilder.addCylinder(
+            glm::vec3(-0.6f, groundLevel + radius, 0.0f), glm::vec3(1.2f, 0.0f, 0.0f), r, n, glm::vec2(5.0f, 5.0f));
+    //up fallen trunk
+    subMeshes[index(MeshId::UP_TRUNK)] = obstacleBuilder.addCylinder(
+            glm::vec3(-0.7f, 0.3f, 0.0f), glm::vec3(1.4f, 0.0f, 0.0f), r, n, glm::vec2(5.0f, 5.0f));
+    reportMeshStats("obstacles", obstacleBuilder.optimize());
+    obstacleMesh = obstacleBuilder.build();
+    obstacleMesh.upload();
+    meshes[index(MeshId::TRUNK_TOP)] = &obstacleMesh;
+    meshes[index(MeshId::TRUNK_SIDE)] = &obstacleMesh;
+    meshes[index(MeshId::DOWN_TRUNK)] = &obstacleMesh;
+    meshes[index(MeshId::UP_TRUNK)] = &obstacleMesh;
+
+    glm::vec3 endScreenCorners[] = {
+            glm::vec3(-1.0f, -1.0f, 0.0f), // Bottom-left
+            glm::vec3(1.0f, -1.0f, 0.0f),  // Bottom-right
+            glm::vec3(1.0f, 1.0f, 0.0f),   // Top-right
+            glm::vec3(-1.0f, 1.0f, 0.0f)   // Top-left
+    };
+    glm::vec2 endScreenTexCoords[] = {
+            glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f)
+    };
+
+    MeshBuilder quadBuilder;
+    subMeshes[index(MeshId::END_SCREEN)] = quadBuilder.addQuad(endScreenCorners, endScreenTexCoords,
+                                                               glm::vec3(0.0f, 0.0f, 1.0f));
+    quadMesh = quadBuilder.build();
+    quadMesh.upload();
+    meshes[index(MeshId::END_SCREEN)] = &quadMesh;
+}
+
+void Renderer::render(const RenderFrame &frame) {
+    dynamicResolution.resize(frame.framebufferWidth, frame.framebufferHeight);
+
+    // simulated before the scene pass, it never touches the framebuffer
+    particles.update(frame.particleEmissions, frame.particleDt);
+    coins.apply(frame.coinUpdates);
+
+    dynamicResolution.beginScene();
+    // binned for the viewport beginScene just picked
+    lighting.update(frame.lights, frame.view, frame.projection, dynamicResolution.getSceneWidth(),
+                    dynamicResolution.getSceneHeight());
+    drawScene(frame);
+    if (!frame.endScreen && !frame.overdrawHeatmap) {
+        coins.draw(frame.view, frame.projection, frame.cameraPosition, frame.time);
+    }
+    particles.draw(frame.view, frame.projection, frame.cameraPosition);
+    debugDraw.draw(frame.debugLines, frame.projection * frame.view);
+    dynamicResolution.endScene();
+
+    GLState::setEnabled(GL_CULL_FACE, true);
+    GLState::setEnabled(GL_BLEND, true);
+    textShader.use();
+    glUniformMatrix4fv(glGetUniformLocation(textShader.ID, "projection"), 1, GL_FALSE,
+                       glm::value_ptr(frame.textProjection));
+    for (const TextCommand &text : frame.texts) {
+        renderText(text);
+    }
+}
+
+void Renderer::drawScene(const RenderFrame &frame) {
+    if (frame.overdrawHeatmap) {
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    } else {
+        glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+    }
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    GLState::setEnabled(GL_CULL_FACE, false);
+    GLState::setEnabled(GL_BLEND, false);
+
+    if (frame.depthPrepass) {
+        // depth only, the shading pass below then touches every pixel once
+        overdrawShader.use();
+        overdrawShader.setMat4("projection", frame.projection);
+        overdrawShader.setMat4("view", frame.view);
+        GLState::colorMask(false);
+        drawCommands(frame, overdrawShader, false);
+        GLState::colorMask(true);
+        GLState::depthFunc(GL_LEQUAL);
+        GLState::depthMask(false);
+    }
+
+    if (frame.overdrawHeatmap) {
+        // same draws and depth state as the real pass, so the heat shows
+        // what the fog shader would actually have run on
+        readOverdrawQuery();
+        overdrawShader.use();
+        overdrawShader.setMat4("projection", frame.projection);
+        overdrawShader.setMat4("view", frame.view);
+        GLState::setEnabled(GL_BLEND, true);
+        GLState::blendFunc(GL_ONE, GL_ONE);
+        bool startQuery = !overdrawQueryPending;
+        if (startQuery) {
+            glBeginQuery(GL_SAMPLES_PASSED, overdrawQuery);
+        }
+        drawCommands(frame, overdrawShader, false);
+        if (startQuery) {
+            glEndQuery(GL_SAMPLES_PASSED);
+            overdrawQueryPending = true;
+            overdrawQueryPixels = static_cast<double>(dynamicResolution.getSceneWidth()) *
+                                  dynamicResolution.getSceneHeight();
+        }
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::setEnabled(GL_BLEND, false);
+    } else {
+        sceneShader.use();
+        sceneShader.setBool("endGame", frame.endScreen);
+        sceneShader.setMat4("projection", frame.projection);
+        sceneShader.setMat4("view", frame.view);
+        sceneShader.setVec3("cameraPos", frame.cameraPosition);
+        lighting.bind(sceneShader);
+        drawCommands(frame, sceneShader, true);
+    }
+
+    // endScene clears depth, which needs the depth mask back on
+    GLState::depthFunc(GL_LESS);
+    GLState::depthMask(true);
+}
+
+void Renderer::drawCommands(const RenderFrame &frame, Shader &shader, bool materials) {
+    // consecutive commands often share mesh and texture; GLState drops the
+    // repeated binds, the uniform is only set when the material changes
+    TextureId boundTexture = TextureId::COUNT;
+    for (const DrawCommand &command : frame.draws) {
+        const Mesh *mesh = meshes[index(command.mesh)];
+        GLState::bindVertexArray(mesh->VAO);
+        if (materials) {
+            if (command.texture != boundTexture) {
+                shader.setBool("useTexture", command.texture != TextureId::NONE);
+                boundTexture = command.texture;
+            }
+            GLState::bindTexture(0, GL_TEXTURE_2D, textures[index(command.texture)]);
+            shader.setVec3("MyColor", command.color);
+        }
+        shader.setMat4("model", command.model);
+        mesh->draw(subMeshes[index(command.mesh)]);
+    }
+}
+
+void Renderer::readOverdrawQuery() {
+    if (!overdrawQueryPending) {
+        return;
+    }
+    GLuint available = 0;
+    glGetQueryObjectuiv(overdrawQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return;
+    }
+    GLuint samples = 0;
+    glGetQueryObjectuiv(overdrawQuery, GL_QUERY_RESULT, &samples);
+    overdrawQueryPending = false;
+
+    if (overdrawQueryPixels > 0.0) {
+        overdrawSum += samples / overdrawQueryPixels;
+        overdrawResults++;
+    }
+    if (overdrawResults == overdrawReportInterval) {
+        std::cout << "OVERDRAW:: " << std::fixed << std::setprecision(2) << overdrawSum / overdrawResults
+                  << " shaded fragments per pixel" << std::defaultfloat << std::endl;
+        overdrawSum = 0.0;
+        overdrawResults = 0;
+    }
+}
+
+void Renderer::renderText(const TextCommand &text) {
+    // activate corresponding render state
+    glUniform3f(glGetUniformLocation(textShader.ID, "textColor"), text.color.x, text.color.y, text.color.z);
+    GLState::bindVertexArray(textVAO);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, textVBO);
+
+    float x = text.position.x;
+    float y = text.position.y;
+    float scale = text.scale;
+
+    // iterate through all characters
+    for (const char *c = text.text; *c; c++) {
+        Character ch = characters[*c];
+
+        float xpos = x + ch.Bearing.x * scale;
+        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
+
+        float w = ch.Size.x * scale;
+        float h = ch.Size.y * scale;
+        // update VBO for each character
+        float vertices[6][4] = {
+                {xpos,     ypos + h, 0.0f, 0.0f},
+                {xpos,     ypos,     0.0f, 1.0f},
+                {xpos + w, ypos,     1.0f, 1.0f},
+
+                {xpos,     ypos + h, 0.0f, 0.0f},
+                {xpos + w, ypos,     1.0f, 1.0f},
+                {xpos + w, ypos + h, 1.0f, 0.0f}
+        };
+        // render glyph texture over quad
+        GLState::bindTexture(0, GL_TEXTURE_2D, ch.TextureID);
+        // update content of VBO memory
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices),
+                        vertices); // be sure to use glBufferSubData and not glBufferData
+
+        // render quad
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+        x += (ch.Advance >> 6) *
+             scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
+    }
+}
+
+void Renderer::present(GLFWwindow *window, const RenderFrame &frame) {
+    if (frame.swapMode != appliedSwapMode) {
+        framePacer.setSwapMode(frame.swapMode);
+        appliedSwapMode = frame.swapMode;
+    }
+    framePacer.setLowPower(frame.lowPower);
+
+    if (frame.screenshotCount != screenshotCount) {
+        screenshotCount = frame.screenshotCount;
+        frameCapture.requestScreenshot();
+    }
+    frameCapture.setRecording(frame.recording);
+    frameCapture.capture(frame.framebufferWidth, frame.framebufferHeight);
+
+    framePacer.waitForNextFrame();
+
+    glfwSwapBuffers(window);
+    framePacer.endFrame();
+
+    if (++stateReportFrames == stateReportInterval) {
+        GLState::report();
+        stateReportFrames = 0;
+    }
+}
+
+void Renderer::release() {
+    frameCapture.release();
+    debugDraw.release();
+    particles.release();
+    coins.release();
+    lighting.release();
+    dynamicResolution.release();
+    ballMesh.release();
+    pathMesh.release();
+    wallMesh.release();
+    obstacleMesh.release();
+    quadMesh.release();
+
+    GLState::deleteTextures(static_cast<GLsizei>(index(TextureId::COUNT)), textures);
+    for (const auto &character : characters) {
+        GLState::deleteTextures(1, &character.second.TextureID);
+    }
+    GLState::deleteVertexArrays(1, &textVAO);
+    GLState::deleteBuffers(1, &textVBO);
+    GLState::deleteProgram(sceneShader.ID);
+    GLState::deleteProgram(textShader.ID);
+    GLState::deleteProgram(overdrawShader.ID);
+    glDeleteQueries(1, &overdrawQuery);
+}
@@ -1,4 +1,6 @@
 #include <Shader.hpp>
+#include <GLState.hpp>
+#include <ProgramBinaryCache.hpp>
 
 Shader::Shader(const char *vertexPath, const char *fragmentPath) {
 
@@ -18,6 +20,17 @@ Shader::Shader(const std::string vertexPath, const std::string fragmentPath) {
   compileShader();
 }
 
+// vertex-only program for transform feedback
+// ------------------------------------------------------------------------
+Shader::Shader(const std::string vertexPath,
+               const std::vector<std::string> &feedbackVaryings)
+    : feedbackVaryings(feedbackVaryings) {
+
+  readShader(vertexPath.c_str(), SHADER_TYPE::VERTEX);
+
+  compileShader();
+}
+
 void Shader::readShader(char const *const shaderPath,
                         Shader::SHADER_TYPE type) {
 
@@ -66,8 +79,18 @@ void Shader::readShader(char const *const shaderPath,
 }
 
 void Shader::compileShader() {
+  ID = glCreateProgram();
+
+  // 1. try the binary cache first, the sources are its key; the captured
+  // varyings are link state, so they are part of it as well
+  std::string cacheKey = this->vertexShader + '\0' + this->fragmentShader;
+  for (const std::string &varying : feedbackVaryings)
+    cacheKey += '\0' + varying;
+  if (ProgramBinaryCache::load(ID, cacheKey))
+    return;
+
   // 2. compile shaders
-  unsigned int vertex, fragment;
+  unsigned int vertex, fragment = 0;
 
   // vertex shader
   GLchar const *vShdCode = this->vertexShader.c_str();
@@ -77,28 +100,45 @@ void Shader::compileShader() {
   glCompileShader(vertex);
   checkCompileErrors(vertex, "VERTEX");
 
-  // fragment Shader
-  GLchar const *fShdCode = this->fragmentShader.c_str();
-  fragment = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragment, 1, &fShdCode, nullptr);
-  glCompileShader(fragment);
-  checkCompileErrors(fragment, "FRAGMENT");
+  // fragment Shader, transform feedback programs have none
+  if (!this->fragmentShader.empty()) {
+    GLchar const *fShdCode = this->fragmentShader.c_str();
+    fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fShdCode, nullptr);
+    glCompileShader(fragment);
+    checkCompileErrors(fragment, "FRAGMENT");
+  }
 
   // shader Program
-  ID = glCreateProgram();
+  bool cacheable = ProgramBinaryCache::isSupported();
+  if (cacheable)
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
   glAttachShader(ID, vertex);
-  glAttachShader(ID, fragment);
+  if (fragment)
+    glAttachShader(ID, fragment);
+  if (!feedbackVaryings.empty()) {
+    std::vector<const GLchar *> names;
+    for (const std::string &varying : feedbackVaryings)
+      names.push_back(varying.c_str());
+    glTransformFeedbackVaryings(ID, static_cast<GLsizei>(names.size()),
+                                names.data(), GL_INTERLEAVED_ATTRIBS);
+  }
   glLinkProgram(ID);
-  checkCompileErrors(ID, "PROGRAM");
+  if (checkCompileErrors(ID, "PROGRAM") && cacheable)
+    ProgramBinaryCache::store(ID, cacheKey);
   // delete the shaders as they're linked into our program now and no longer
   // necessary
+  glDetachShader(ID, vertex);
   glDeleteShader(vertex);
-  glDeleteShader(fragment);
+  if (fragment) {
+    glDetachShader(ID, fragment);
+    glDeleteShader(fragment);
+  }
 }
 
 // activate the shader
 // ------------------------------------------------------------------------
-void Shader::use() { glUseProgram(ID); }
+void Shader::use() { GLState::useProgram(ID); }
 // utility uniform functions
 // ------------------------------------------------------------------------
 void Shader::setBool(const std::string &name, bool value) const {
@@ -153,7 +193,7 @@ void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
 
 // utility function for checking shader compilation/linking errors.
 // ------------------------------------------------------------------------
-void Shader::checkCompileErrors(unsigned int shader, std::string type) {
+bool Shader::checkCompileErrors(unsigned int shader, std::string type) {
   int success;
   char infoLog[1024];
   if (type != "PROGRAM") {
@@ -177,4 +217,5 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type) {
           << std::endl;
     }
   }
+  return success != 0;
 }
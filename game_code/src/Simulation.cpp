@@ -0,0 +1,233 @@
+#include "Simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "AABB_CollisionDetection.hpp"
+
+Simulation::Simulation(const std::vector<float> &lanes, float laneSwitchSpeed, float jumpSpeed, float crouchSpeed,
+                       float groundLevel, float startZ, float length, int numSegments, int obstacleCapacity,
+                       int coinCapacity, float stepSize, std::uint64_t seed)
+        : lanes(lanes), groundLevel(groundLevel),
+          camera(glm::vec3(0.0f, 0.5f, 2.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -5.0f),
+          player(lanes, 1, laneSwitchSpeed, jumpSpeed, crouchSpeed),
+          numSegments(numSegments), segmentLength(length / numSegments),
+          obstacles(obstacleCapacity), obstacleGrid(lanes, 1.0f, 64, obstacleCapacity), coins(coinCapacity),
+          startZ(startZ),
+          // the near half of the path stays free, and a full path of chunks
+          // is kept ready beyond what is already placed
+          chunks(lanes, segmentLength, (numSegments / 2) * segmentLength, numSegments, seed,
+                 SolvabilityChecker(lanes, laneSwitchSpeed, jumpSpeed, crouchSpeed, groundLevel, forwardSpeed,
+                                    stepSize, segmentLength)),
+          chunkEnd((numSegments / 2) * segmentLength) {
+    for (int i = 0; i < numSegments; i++) {
+        segmentZ.push_back(startZ - i * segmentLength);
+    }
+
+    //obstacle preparation
+    playerStartPos = player.GetPosition().z;
+    endZ = startZ - length;
+
+    spawnChunks(endZ);
+
+    previous = snapshot();
+}
+
+void Simulation::step(const PlayerInput &input, float dt) {
+    previous = snapshot();
+    time += dt;
+
+    player.ProcessInput(input.left, input.right, input.up, input.down, dt);
+
+    // endless running
+    camera.ProcessKeyboard(FORWARD, dt);
+    player.MoveForward(forwardSpeed, dt);
+
+    playerRotationAngle += rotationSpeed * dt;
+    if (playerRotationAngle >= 360.0f) {
+        // keep the previous angle on the same turn so interpolation does
+        // not spin the ball backwards
+        playerRotationAngle -= 360.0f;
+        previous.playerRotationAngle -= 360.0f;
+    }
+
+    // the world freezes once the player hit something, only the camera and
+    // the ball keep moving behind the end screen
+    if (!gameOver) {
+        detectCollisions(previous.playerPosition, dt);
+        if (!gameOver) {
+            collectCoins(previous.playerPosition);
+        }
+        // a long step can cross more than one segment
+        while (std::abs(playerStartPos - player.GetPosition().z) >= segmentLength) {
+            recycleSegment();
+        }
+    }
+}
+
+SimulationSnapshot Simulation::interpolate(float alpha) const {
+    SimulationSnapshot current = snapshot();
+    SimulationSnapshot blended;
+    blended.playerPosition = glm::mix(previous.playerPosition, current.playerPosition, alpha);
+    blended.cameraPosition = glm::mix(previous.cameraPosition, current.cameraPosition, alpha);
+    blended.playerRotationAngle = glm::mix(previous.playerRotationAngle, current.playerRotationAngle, alpha);
+    return blended;
+}
+
+SimulationSnapshot Simulation::snapshot() const {
+    SimulationSnapshot state;
+    state.playerPosition = player.GetPosition();
+    state.cameraPosition = camera.Position;
+    state.playerRotationAngle = playerRotationAngle;
+    return state;
+}
+
+// The player box is swept from where it was before the step to where it is
+// now, so a thin trunk cannot be skipped however long the step is. The
+// motion within one step is taken as a straight line.
+void Simulation::detectCollisions(const glm::vec3 &startPosition, float dt) {
+    CollisionDetector playerBox = CollisionDetector();
+    playerBox.getPlayer(player, groundLevel);
+    glm::vec3 displacement = player.GetPosition() - startPosition;
+    glm::vec3 lo = playerBox.getMin() - displacement;
+    glm::vec3 hi = playerBox.getMax() - displacement;
+
+    // only the few cells the swept box passes through are looked at
+    sweepCandidates.clear();
+    obstacleGrid.queryBox(glm::min(lo, lo + displacement), glm::max(hi, hi + displacement), sweepCandidates);
+
+    AabbColumns boxes = obstacles.boxes();
+    CollisionDetector mover(lo, hi);
+    int hit = -1;
+    float hitTime = 1.0f;
+    for (int i : sweepCandidates) {
+        CollisionDetector obstacleBox(glm::vec3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]),
+                                      glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]));
+        float toi;
+        if (mover.sweep(displacement, obstacleBox, toi) && (hit < 0 || toi < hitTime)) {
+            hit = i;
+            hitTime = toi;
+        }
+    }
+    if (hit < 0) {
+        return;
+    }
+
+    gameOver = true;
+    collisionTime = time - (1.0f - hitTime) * dt;
+    // the contact happens where the box touches, not where the step ended
+    lo += displacement * hitTime;
+    hi += displacement * hitTime;
+    collisionPoint = 0.5f * (glm::max(lo, glm::vec3(boxes.minX[hit], boxes.minY[hit], boxes.minZ[hit])) +
+                             glm::min(hi, glm::vec3(boxes.maxX[hit], boxes.maxY[hit], boxes.maxZ[hit])));
+}
+
+// The swept player box is tested against every live coin at once. The
+// coins ahead of the player are only a few segments' worth, and the batch
+// test goes through them several at a time.
+void Simulation::collectCoins(const glm::vec3 &startPosition) {
+    CollisionDetector playerBox = CollisionDetector();
+    playerBox.getPlayer(player, groundLevel);
+    glm::vec3 displacement = player.GetPosition() - startPosition;
+    glm::vec3 lo = glm::min(playerBox.getMin(), playerBox.getMin() - displacement);
+    glm::vec3 hi = glm::max(playerBox.getMax(), playerBox.getMax() - displacement);
+
+    AabbColumns boxes = coins.boxes();
+    CoinStore::Range ranges[2];
+    int rangeCount = coins.liveRanges(ranges);
+    for (int r = 0; r < rangeCount; r++) {
+        if (overlapBatch(lo, hi, boxes, ranges[r].begin, ranges[r].end, coinHits) < 0) {
+            continue;
+        }
+        for (std::size_t word = 0; word < coinHits.size(); word++) {
+            std::uint64_t bits = coinHits[word];
+            while (bits) {
+                int bit = 0;
+                while (!((bits >> bit) & 1u)) {
+                    bit++;
+                }
+                bits &= bits - 1;
+
+                int slot = ranges[r].begin + static_cast<int>(word) * 64 + bit;
+                if (!coins.isCollected(slot)) {
+                    coins.collect(slot);
+                    coinsCollected++;
+                    coinUpdates.push_back(CoinUpdate{slot, glm::vec3(0.0f), false});
+                }
+            }
+        }
+    }
+}
+
+void Simulation::recycleSegment() {
+    playerStartPos -= segmentLength;
+
+    // everything on the segment left behind is out of reach now
+    float behind = segmentZ[pointer] - segmentLength;
+    while (!obstacles.empty() && obstacles.positionZ()[obstacles.oldest()] > behind) {
+        obstacleGrid.remove(obstacles.oldest());
+        obstacles.popOldest();
+    }
+    while (!coins.empty() && coins.positionZ()[coins.oldest()] > behind) {
+        if (!coins.isCollected(coins.oldest())) {
+            coinUpdates.push_back(CoinUpdate{coins.oldest(), glm::vec3(0.0f), false});
+        }
+        coins.popOldest();
+    }
+
+    // move the segment behind the player to the far end
+    segmentZ[pointer] = endZ;
+
+    endZ -= segmentLength;
+
+    if (pointer == static_cast<unsigned int>(numSegments - 1)) {
+        pointer = 0;
+    } else {
+        pointer++;
+    }
+
+    spawnChunks(endZ);
+}
+
+void Simulation::spawnChunks(float farZ) {
+    // chunks are never split, half a chunk of slack absorbs rounding
+    float farDistance = startZ - farZ - 0.5f * segmentLength;
+    // a chunk the worker has not finished yet is picked up on a later
+    // recycle. One that ends up starting less than a segment ahead of the
+    // player is dropped whole: its obstacles would appear in the player's
+    // face or behind them. Leaving obstacles out never makes the track
+    // harder, so the chunks after it stay passable.
+    float playerDistance = startZ - player.GetPosition().z;
+    for (const Chunk *chunk = chunks.front(); chunk && chunk->startDistance < farDistance; chunk = chunks.front()) {
+        chunkEnd = chunk->startDistance + segmentLength;
+        if (chunk->startDistance < playerDistance + segmentLength) {
+            std::cout << "CHUNKS::LATE dropped the chunk at " << chunk->startDistance << ", the player is at "
+                      << playerDistance << std::endl;
+            chunks.pop();
+            continue;
+        }
+        for (int i = 0; i < chunk->count; i++) {
+            const ObstacleSpawn &spawn = chunk->obstacles[i];
+            glm::vec3 position(lanes[spawn.lane], groundLevel, startZ - spawn.distance);
+            if (obstacles.push(spawn.kind, spawn.lane, position)) {
+                int slot = obstacles.newest();
+                AabbColumns boxes = obstacles.boxes();
+                obstacleGrid.insert(slot, glm::vec3(boxes.minX[slot], boxes.minY[slot], boxes.minZ[slot]),
+                                    glm::vec3(boxes.maxX[slot], boxes.maxY[slot], boxes.maxZ[slot]));
+            }
+        }
+        // coin heights are above the standing player, whose center is at 0
+        for (int i = 0; i < chunk->coinCount; i++) {
+            const CoinSpawn &spawn = chunk->coins[i];
+            glm::vec3 position(lanes[spawn.lane], spawn.height, startZ - spawn.distance);
+            if (coins.push(position)) {
+                coinUpdates.push_back(CoinUpdate{coins.newest(), position, true});
+            }
+        }
+        chunks.pop();
+    }
+    if (chunkEnd < farDistance) {
+        std::cout << "CHUNKS::STARVED the generator is behind, the track ends at " << chunkEnd << std::endl;
+    }
+}
@@ -0,0 +1,266 @@
+#include "SolvabilityChecker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "AABB_CollisionDetection.hpp"
+#include "Player.hpp"
+
+namespace {
+
+// seconds of running per checker step, rounded so a chunk is a whole
+// number of steps
+const float NOMINAL_STEP_TIME = 1.0f / 60.0f;
+
+enum ProbeAction { PROBE_LEFT, PROBE_RIGHT, PROBE_JUMP, PROBE_CROUCH };
+
+typedef std::vector<glm::vec3> Recording;
+
+// player position before and after every simulation step of one action,
+// from the key press until the action is over. The motion is a function of
+// time, so it is evaluated at the step times rather than stepped through.
+Recording recordAction(Player player, ProbeAction action, float stepSize) {
+    float start = player.getTime();
+    // an empty step only starts the action
+    player.ProcessInput(action == PROBE_LEFT, action == PROBE_RIGHT, action == PROBE_JUMP, action == PROBE_CROUCH,
+                        0.0f);
+    int steps = static_cast<int>(std::ceil((player.getRestTime() - start) / stepSize));
+    Recording samples;
+    for (int i = 0; i <= steps; i++) {
+        samples.push_back(player.GetPositionAt(start + i * stepSize));
+    }
+    return samples;
+}
+
+int phaseCount(const std::vector<Recording> &recordings, float stepSize, float phaseTime) {
+    int count = 1;
+    for (const Recording &samples : recordings) {
+        float duration = (samples.size() - 1) * stepSize;
+        count = std::max(count, static_cast<int>(std::ceil(duration / phaseTime)));
+    }
+    return count;
+}
+
+// range of one coordinate over the samples of every recording within phase,
+// widened by one sample either side so the motion between samples is
+// covered too. A recording that already ended counts with where it ended.
+void phaseRange(const std::vector<Recording> &recordings, int axis, int phase, float stepSize, float phaseTime,
+                float &lo, float &hi) {
+    lo = std::numeric_limits<float>::max();
+    hi = -std::numeric_limits<float>::max();
+    for (const Recording &samples : recordings) {
+        int last = static_cast<int>(samples.size()) - 1;
+        int first = std::min(last, std::max(0, static_cast<int>(std::floor(phase * phaseTime / stepSize)) - 1));
+        int end = std::min(last, static_cast<int>(std::ceil((phase + 1) * phaseTime / stepSize)) + 1);
+        for (int i = first; i <= end; i++) {
+            lo = std::min(lo, samples[i][axis]);
+            hi = std::max(hi, samples[i][axis]);
+        }
+    }
+}
+
+} // namespace
+
+SolvabilityChecker::SolvabilityChecker(const std::vector<float> &lanes, float laneSwitchSpeed, float jumpSpeed,
+                                       float crouchSpeed, float groundLevel, float forwardSpeed, float stepSize,
+                                       float chunkLength)
+        : lanes(lanes), groundLevel(groundLevel) {
+    stepsPerChunk = std::max(1, static_cast<int>(std::ceil(chunkLength / (forwardSpeed * NOMINAL_STEP_TIME))));
+    stepLength = chunkLength / stepsPerChunk;
+    float phaseTime = stepLength / forwardSpeed;
+
+    int laneCount = static_cast<int>(lanes.size());
+    Player probe(lanes, 0, laneSwitchSpeed, jumpSpeed, crouchSpeed);
+
+    CollisionDetector playerBox;
+    playerBox.getPlayer(probe, groundLevel);
+    glm::vec3 halfSize = (playerBox.getMax() - playerBox.getMin()) * 0.5f;
+    halfWidth = halfSize.x;
+    halfHeight = halfSize.y;
+    halfDepth = halfSize.z;
+    float obstacleDepth = 0.0f;
+    for (const ObstacleTraits &traits : OBSTACLE_CATALOG) {
+        obstacleDepth = std::max(obstacleDepth, std::max(-traits.boxMin[2], traits.boxMax[2]));
+    }
+    lagSteps = static_cast<int>(std::ceil((halfDepth + obstacleDepth) / stepLength));
+
+    // jumps and crouches end exactly on the ground, so the next action
+    // starts from the same height and one recording of each is enough
+    float restY = probe.GetPosition().y;
+    std::vector<Recording> jumps(1, recordAction(probe, PROBE_JUMP, stepSize));
+    std::vector<Recording> crouches(1, recordAction(probe, PROBE_CROUCH, stepSize));
+    standingBottom = restY - halfHeight - groundLevel;
+    standingTop = restY + halfHeight - groundLevel;
+    jumpHeight = 0.0f;
+    for (const glm::vec3 &sample : jumps[0]) {
+        jumpHeight = std::max(jumpHeight, sample.y - restY);
+    }
+
+    // vertical phases: 0 standing, then the jump, then the crouch
+    int jumpPhases = phaseCount(jumps, stepSize, phaseTime);
+    int crouchPhases = phaseCount(crouches, stepSize, phaseTime);
+    verticalCount = 1 + jumpPhases + crouchPhases;
+    std::vector<float> minY(verticalCount, restY), maxY(verticalCount, restY);
+    for (int v = 0; v < jumpPhases; v++) {
+        phaseRange(jumps, 1, v, stepSize, phaseTime, minY[1 + v], maxY[1 + v]);
+    }
+    for (int v = 0; v < crouchPhases; v++) {
+        phaseRange(crouches, 1, v, stepSize, phaseTime, minY[1 + jumpPhases + v], maxY[1 + jumpPhases + v]);
+    }
+
+    // lane switches, recorded from every lane they can start in
+    struct Switch {
+        int from, to;
+        std::vector<Recording> samples;
+    };
+    std::vector<Switch> switches;
+    float laneSlack = 0.0f;
+    for (int lane = 0; lane < laneCount; lane++) {
+        if (lane > 0) {
+            Player start(lanes, lane, laneSwitchSpeed, jumpSpeed, crouchSpeed);
+            switches.push_back({lane, lane - 1, std::vector<Recording>(1, recordAction(start, PROBE_LEFT, stepSize))});
+        }
+        if (lane + 1 < laneCount) {
+            Player start(lanes, lane, laneSwitchSpeed, jumpSpeed, crouchSpeed);
+            switches.push_back({lane, lane + 1, std::vector<Recording>(1, recordAction(start, PROBE_RIGHT, stepSize))});
+        }
+    }
+    for (const Switch &s : switches) {
+        laneSlack = std::max(laneSlack, std::abs(s.samples[0].back().x - lanes[s.to]));
+    }
+
+    // state = lane * verticalCount + vertical phase, the switches follow
+    for (int lane = 0; lane < laneCount; lane++) {
+        for (int v = 0; v < verticalCount; v++) {
+            addState(lanes[lane] - laneSlack, lanes[lane] + laneSlack, minY[v], maxY[v]);
+        }
+    }
+    std::vector<int> switchFirst;
+    for (const Switch &s : switches) {
+        int phases = phaseCount(s.samples, stepSize, phaseTime);
+        switchFirst.push_back(static_cast<int>(states.size()));
+        for (int p = 0; p < phases; p++) {
+            float lo, hi;
+            phaseRange(s.samples, 0, p, stepSize, phaseTime, lo, hi);
+            addState(lo - laneSlack, hi + laneSlack, restY, restY);
+        }
+    }
+
+    for (int lane = 0; lane < laneCount; lane++) {
+        int ground = lane * verticalCount;
+        std::vector<int> &fromGround = successors[ground];
+        fromGround.push_back(ground);
+        fromGround.push_back(ground + 1);
+        fromGround.push_back(ground + 1 + jumpPhases);
+        for (int v = 1; v < verticalCount; v++) {
+            bool lastPhase = v == jumpPhases || v == verticalCount - 1;
+            successors[ground + v].push_back(lastPhase ? ground : ground + v + 1);
+        }
+    }
+    for (std::size_t i = 0; i < switches.size(); i++) {
+        int first = switchFirst[i];
+        int end = i + 1 < switches.size() ? switchFirst[i + 1] : static_cast<int>(states.size());
+        successors[switches[i].from * verticalCount].push_back(first);
+        for (int s = first; s < end; s++) {
+            successors[s].push_back(s + 1 < end ? s + 1 : switches[i].to * verticalCount);
+        }
+    }
+
+    wordCount = (static_cast<int>(states.size()) + 63) / 64;
+    current.assign(wordCount, 0);
+    next.assign(wordCount, 0);
+    blocked.assign(wordCount, 0);
+}
+
+void SolvabilityChecker::addState(float minX, float maxX, float minY, float maxY) {
+    states.push_back({minX, maxX, minY, maxY});
+    successors.push_back(std::vector<int>());
+}
+
+SolvabilityChecker::StateSet SolvabilityChecker::groundStates() const {
+    StateSet set(wordCount, 0);
+    for (std::size_t lane = 0; lane < lanes.size(); lane++) {
+        int state = static_cast<int>(lane) * verticalCount;
+        set[state / 64] |= std::uint64_t(1) << (state % 64);
+    }
+    return set;
+}
+
+bool SolvabilityChecker::advance(float startDistance, const ObstacleSpawn *obstacles, int count, StateSet &reach) {
+    current = reach;
+    for (int step = 0; step < stepsPerChunk; step++) {
+        float nearDistance = startDistance + (step - lagSteps) * stepLength;
+        markBlocked(nearDistance, nearDistance + stepLength, obstacles, count);
+
+        std::fill(next.begin(), next.end(), 0);
+        for (int word = 0; word < wordCount; word++) {
+            std::uint64_t bits = current[word];
+            for (int bit = 0; bits != 0; bit++, bits >>= 1) {
+                if (bits & 1) {
+                    for (int to : successors[word * 64 + bit]) {
+                        next[to / 64] |= std::uint64_t(1) << (to % 64);
+                    }
+                }
+            }
+        }
+
+        std::uint64_t alive = 0;
+        for (int word = 0; word < wordCount; word++) {
+            next[word] &= ~blocked[word];
+            alive |= next[word];
+        }
+        if (alive == 0) {
+            return false;
+        }
+        current.swap(next);
+    }
+    reach = current;
+    return true;
+}
+
+// every state whose box, swept from nearDistance to farDistance, touches
+// one of the obstacles
+void SolvabilityChecker::markBlocked(float nearDistance, float farDistance, const ObstacleSpawn *obstacles,
+                                     int count) {
+    std::fill(blocked.begin(), blocked.end(), 0);
+    float minZ = -farDistance - halfDepth;
+    float maxZ = -nearDistance + halfDepth;
+    for (int i = 0; i < count; i++) {
+        const ObstacleSpawn &obstacle = obstacles[i];
+        CollisionDetector box;
+        box.getObstacle(glm::vec3(lanes[obstacle.lane], groundLevel, -obstacle.distance), obstacle.kind);
+        const glm::vec3 &min = box.getMin();
+        const glm::vec3 &max = box.getMax();
+        if (minZ > max.z || maxZ < min.z) {
+            continue;
+        }
+        for (std::size_t s = 0; s < states.size(); s++) {
+            const StateRange &state = states[s];
+            if (state.minX - halfWidth <= max.x && state.maxX + halfWidth >= min.x &&
+                state.minY - halfHeight <= max.y && state.maxY + halfHeight >= min.y) {
+                blocked[s / 64] |= std::uint64_t(1) << (s % 64);
+            }
+        }
+    }
+}
+
+int SolvabilityChecker::getStateCount() const {
+    return static_cast<int>(states.size());
+}
+
+int SolvabilityChecker::getStepsPerChunk() const {
+    return stepsPerChunk;
+}
+
+float SolvabilityChecker::getStandingBottom() const {
+    return standingBottom;
+}
+
+float SolvabilityChecker::getStandingTop() const {
+    return standingTop;
+}
+
+float SolvabilityChecker::getJumpHeight() const {
+    return jumpHeight;
+}
@@ -0,0 +1,158 @@
+#include "SpatialGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(const std::vector<float> &laneCenters, float bucketDepth, int bucketCount, int capacity)
+        : bucketDepth(bucketDepth), bucketCount(std::max(bucketCount, 1)),
+          cells(std::max<std::size_t>(laneCenters.size(), 1) * std::max(bucketCount, 1)),
+          items(capacity), stamps(capacity, 0) {
+    std::vector<float> centers(laneCenters);
+    std::sort(centers.begin(), centers.end());
+    for (std::size_t i = 1; i < centers.size(); i++) {
+        laneEdges.push_back(0.5f * (centers[i - 1] + centers[i]));
+    }
+    for (Item &item : items) {
+        item.live = false;
+    }
+}
+
+int SpatialGrid::laneOf(float x) const {
+    return static_cast<int>(std::upper_bound(laneEdges.begin(), laneEdges.end(), x) - laneEdges.begin());
+}
+
+int SpatialGrid::bucketOf(float z) const {
+    return static_cast<int>(std::floor(z / bucketDepth));
+}
+
+std::vector<int> &SpatialGrid::cell(int lane, int bucket) {
+    int row = bucket % bucketCount;
+    if (row < 0) {
+        row += bucketCount;
+    }
+    return cells[lane * bucketCount + row];
+}
+
+void SpatialGrid::insert(int id, const glm::vec3 &min, const glm::vec3 &max) {
+    if (items[id].live) {
+        remove(id);
+    }
+    Item &item = items[id];
+    item.min = min;
+    item.max = max;
+    item.firstLane = laneOf(min.x);
+    item.lastLane = laneOf(max.x);
+    item.firstBucket = bucketOf(min.z);
+    // a box longer than the ring already sits in every row
+    item.lastBucket = std::min(bucketOf(max.z), item.firstBucket + bucketCount - 1);
+    item.live = true;
+
+    for (int lane = item.firstLane; lane <= item.lastLane; lane++) {
+        for (int bucket = item.firstBucket; bucket <= item.lastBucket; bucket++) {
+            cell(lane, bucket).push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::remove(int id) {
+    Item &item = items[id];
+    if (!item.live) {
+        return;
+    }
+    for (int lane = item.firstLane; lane <= item.lastLane; lane++) {
+        for (int bucket = item.firstBucket; bucket <= item.lastBucket; bucket++) {
+            std::vector<int> &ids = cell(lane, bucket);
+            std::vector<int>::iterator it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+        }
+    }
+    item.live = false;
+}
+
+void SpatialGrid::clear() {
+    for (std::vector<int> &ids : cells) {
+        ids.clear();
+    }
+    for (Item &item : items) {
+        item.live = false;
+    }
+}
+
+void SpatialGrid::gather(int firstLane, int lastLane, int firstBucket, int lastBucket, std::vector<int> &out) {
+    if (++stamp == 0) {
+        // wrapped around, old stamps could collide with the new ones
+        std::fill(stamps.begin(), stamps.end(), 0u);
+        stamp = 1;
+    }
+    firstLane = std::max(firstLane, 0);
+    lastLane = std::min(lastLane, getLaneCount() - 1);
+    lastBucket = std::min(lastBucket, firstBucket + bucketCount - 1);
+    for (int lane = firstLane; lane <= lastLane; lane++) {
+        for (int bucket = firstBucket; bucket <= lastBucket; bucket++) {
+            for (int id : cell(lane, bucket)) {
+                if (stamps[id] != stamp) {
+                    stamps[id] = stamp;
+                    out.push_back(id);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryBox(const glm::vec3 &min, const glm::vec3 &max, std::vector<int> &out) {
+    std::size_t first = out.size();
+    gather(laneOf(min.x), laneOf(max.x), bucketOf(min.z), bucketOf(max.z), out);
+
+    std::size_t kept = first;
+    for (std::size_t i = first; i < out.size(); i++) {
+        const Item &item = items[out[i]];
+        if (glm::all(glm::lessThanEqual(min, item.max)) && glm::all(glm::greaterThanEqual(max, item.min))) {
+            out[kept++] = out[i];
+        }
+    }
+    out.resize(kept);
+}
+
+void SpatialGrid::queryRadius(const glm::vec3 &center, float radius, std::vector<int> &out) {
+    std::size_t first = out.size();
+    gather(laneOf(center.x - radius), laneOf(center.x + radius), bucketOf(center.z - radius),
+           bucketOf(center.z + radius), out);
+
+    std::size_t kept = first;
+    for (std::size_t i = first; i < out.size(); i++) {
+        const Item &item = items[out[i]];
+        glm::vec3 closest = glm::clamp(center, item.min, item.max);
+        glm::vec3 offset = closest - center;
+        if (glm::dot(offset, offset) <= radius * radius) {
+            out[kept++] = out[i];
+        }
+    }
+    out.resize(kept);
+}
+
+void SpatialGrid::queryRange(int lane, float z0, float z1, std::vector<int> &out) {
+    float nearZ = std::max(z0, z1);
+    float farZ = std::min(z0, z1);
+    std::size_t first = out.size();
+    if (lane < 0) {
+        gather(0, getLaneCount() - 1, bucketOf(farZ), bucketOf(nearZ), out);
+    } else {
+        gather(lane, lane, bucketOf(farZ), bucketOf(nearZ), out);
+    }
+
+    std::size_t kept = first;
+    for (std::size_t i = first; i < out.size(); i++) {
+        const Item &item = items[out[i]];
+        if (item.min.z <= nearZ && item.max.z >= farZ) {
+            out[kept++] = out[i];
+        }
+    }
+    out.resize(kept);
+}
+
+int SpatialGrid::getLaneCount() const {
+    return static_cast<int>(laneEdges.size()) + 1;
+}
@@ -0,0 +1,142 @@
+#include "TiledLighting.hpp"
+
+#include <algorithm>
+
+#include "GLState.hpp"
+
+namespace {
+
+enum { LIGHT_DATA, TILE_DATA, LIGHT_INDICES };
+
+const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+
+// replaces the whole buffer each frame, orphaning the old storage so the
+// upload never waits for draws still reading it
+template <typename T> void upload(GLuint buffer, const std::vector<T> &data) {
+    GLState::bindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(data.size() * sizeof(T)), data.data(), GL_STREAM_DRAW);
+}
+
+} // namespace
+
+TiledLighting::TiledLighting() {
+    glGenBuffers(3, buffers);
+    glGenTextures(3, textures);
+    for (int i = 0; i < 3; i++) {
+        // never empty, an empty buffer texture is incomplete
+        GLState::bindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+        GLState::bindTexture(FIRST_TEXTURE_UNIT + i, GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+}
+
+bool TiledLighting::tileRange(const PointLight &light, const glm::mat4 &view, const glm::mat4 &projection,
+                              glm::ivec4 &range) const {
+    const float near = projection[3][2] / (projection[2][2] - 1.0f);
+    glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+
+    // entirely behind the camera
+    if (center.z - light.radius > -near) {
+        return false;
+    }
+
+    glm::vec2 lo(1.0f), hi(-1.0f);
+    if (center.z + light.radius > -near) {
+        // the camera is inside or next to the sphere, it can cover anything
+        lo = glm::vec2(-1.0f);
+        hi = glm::vec2(1.0f);
+    } else {
+        // the projected view-space box of the sphere contains its projection
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = center + light.radius * glm::vec3(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f,
+                                                                 i & 4 ? 1.0f : -1.0f);
+            glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+            glm::vec2 ndc = glm::vec2(clip) / clip.w;
+            lo = glm::min(lo, ndc);
+            hi = glm::max(hi, ndc);
+        }
+    }
+
+    if (hi.x < -1.0f || hi.y < -1.0f || lo.x > 1.0f || lo.y > 1.0f) {
+        return false;
+    }
+
+    glm::vec2 tiles(static_cast<float>(tilesX), static_cast<float>(tilesY));
+    glm::vec2 first = glm::clamp((lo * 0.5f + 0.5f) * tiles, glm::vec2(0.0f), tiles - 1.0f);
+    glm::vec2 last = glm::clamp((hi * 0.5f + 0.5f) * tiles, glm::vec2(0.0f), tiles - 1.0f);
+    range = glm::ivec4(static_cast<int>(first.x), static_cast<int>(first.y),
+                       static_cast<int>(last.x), static_cast<int>(last.y));
+    return true;
+}
+
+void TiledLighting::update(const std::vector<PointLight> &lights, const glm::mat4 &view,
+                           const glm::mat4 &projection, int width, int height) {
+    tilesX = std::max((width + TILE_SIZE - 1) / TILE_SIZE, 1);
+    tilesY = std::max((height + TILE_SIZE - 1) / TILE_SIZE, 1);
+    const int tileCount = tilesX * tilesY;
+
+    lightData.clear();
+    ranges.clear();
+    for (const PointLight &light : lights) {
+        glm::ivec4 range;
+        if (!tileRange(light, view, projection, range)) {
+            continue;
+        }
+        lightData.push_back(glm::vec4(light.position, light.radius));
+        lightData.push_back(glm::vec4(light.color, light.intensity));
+        ranges.push_back(range);
+    }
+
+    // pass 1: count the lights per tile
+    tileData.assign(2 * tileCount, 0);
+    for (const glm::ivec4 &range : ranges) {
+        for (int y = range.y; y <= range.w; y++) {
+            for (int x = range.x; x <= range.z; x++) {
+                tileData[2 * (y * tilesX + x) + 1]++;
+            }
+        }
+    }
+
+    // pass 2: offsets from a prefix sum, counts restart while filling
+    GLuint offset = 0;
+    for (int tile = 0; tile < tileCount; tile++) {
+        GLuint count = tileData[2 * tile + 1];
+        tileData[2 * tile] = offset;
+        tileData[2 * tile + 1] = 0;
+        offset += count;
+    }
+
+    // pass 3: fill the flattened lists
+    indices.assign(std::max(offset, 1u), 0);
+    for (std::size_t light = 0; light < ranges.size(); light++) {
+        const glm::ivec4 &range = ranges[light];
+        for (int y = range.y; y <= range.w; y++) {
+            for (int x = range.x; x <= range.z; x++) {
+                GLuint *tile = &tileData[2 * (y * tilesX + x)];
+                indices[tile[0] + tile[1]++] = static_cast<GLuint>(light);
+            }
+        }
+    }
+
+    if (lightData.empty()) {
+        lightData.push_back(glm::vec4(0.0f));
+    }
+    upload(buffers[LIGHT_DATA], lightData);
+    upload(buffers[TILE_DATA], tileData);
+    upload(buffers[LIGHT_INDICES], indices);
+}
+
+void TiledLighting::bind(Shader &shader) const {
+    // the textures never change, after the first frame these are all skipped
+    for (int i = 0; i < 3; i++) {
+        GLState::bindTexture(FIRST_TEXTURE_UNIT + i, GL_TEXTURE_BUFFER, textures[i]);
+    }
+    shader.setInt("tileSize", TILE_SIZE);
+    shader.setInt("tilesX", tilesX);
+}
+
+void TiledLighting::release() {
+    GLState::deleteTextures(3, textures);
+    GLState::deleteBuffers(3, buffers);
+}
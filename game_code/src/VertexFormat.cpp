@@ -0,0 +1,43 @@
+#include "VertexFormat.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+VertexFormat::VertexFormat(GLsizei stride) : stride(stride) {}
+
+VertexFormat &VertexFormat::add(GLuint location, GLint components, GLenum type, GLboolean normalized, std::size_t offset) {
+    VertexAttribute attribute = {location, components, type, normalized, offset};
+    attributes.push_back(attribute);
+    return *this;
+}
+
+void VertexFormat::apply() const {
+    for (const VertexAttribute &attribute : attributes) {
+        glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+                              stride, reinterpret_cast<void *>(attribute.offset));
+        glEnableVertexAttribArray(attribute.location);
+    }
+}
+
+GLsizei VertexFormat::getStride() const {
+    return stride;
+}
+
+PackedVertex packVertex(const glm::vec3 &position, const glm::vec2 &texCoord, const glm::vec3 &normal) {
+    PackedVertex vertex;
+    vertex.position[0] = glm::packHalf1x16(position.x);
+    vertex.position[1] = glm::packHalf1x16(position.y);
+    vertex.position[2] = glm::packHalf1x16(position.z);
+    vertex.padding = 0;
+    vertex.texCoord[0] = glm::packUnorm1x16(texCoord.x / TEXCOORD_RANGE);
+    vertex.texCoord[1] = glm::packUnorm1x16(texCoord.y / TEXCOORD_RANGE);
+    vertex.normal = glm::packSnorm3x10_1x2(glm::vec4(glm::normalize(normal), 0.0f));
+    return vertex;
+}
+
+const VertexFormat &packedVertexFormat() {
+    static const VertexFormat format = VertexFormat(sizeof(PackedVertex))
+            .add(ATTRIB_POSITION, 3, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertex, position))
+            .add(ATTRIB_TEXCOORD, 2, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(PackedVertex, texCoord))
+            .add(ATTRIB_NORMAL, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedVertex, normal));
+    return format;
+}
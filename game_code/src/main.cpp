@@ -1,64 +1,61 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 
-#include <OpenGLPrj.hpp>
-
 #include <GLFW/glfw3.h>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
 #include <Camera.hpp>
-#include <Shader.hpp>
 #include <Player.hpp>
+#include <FramePacer.hpp>
+#include <FixedTimestep.hpp>
+#include <Simulation.hpp>
+#include <RenderFrame.hpp>
+#include <Renderer.hpp>
+#include <TripleBuffer.hpp>
+#include <DebugDraw.hpp>
 #include <AABB_CollisionDetection.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
-#include <random>
-#include <map>
-#include <iomanip>
-#include <sstream>
 #include <algorithm>
 
 const std::string program_name = ("Endless Runner Game");
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
 void processInput(GLFWwindow *window);
-void RenderText(Shader &shader, std::string text, float x, float y, float scale, glm::vec3 color);
-
-GLuint loadTexture(const char* path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    int width, height, nrChannels;
-    unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 0);
-    if (data) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    } else {
-        std::cout << "Failed to load texture: " << path << std::endl;
-    }
-    stbi_image_free(data);
-    return textureID;
-}
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 800;
 
-unsigned int VAO, VBO;
+// frame pacing, F5 cycles the swap mode and F6 toggles low-power mode
+SwapMode swapMode = SwapMode::ADAPTIVE_VSYNC;
+const double frameCap = 0.0; // fps, 0 means uncapped
+bool lowPowerMode = false;
 
-struct Character {
-    unsigned int TextureID; // ID handle of the glyph texture
-    glm::ivec2   Size;      // Size of glyph
-    glm::ivec2   Bearing;   // Offset from baseline to left/top of glyph
-    unsigned int Advance;   // Horizontal offset to advance to next glyph
-};
+// fill-rate diagnostics, F7 toggles the overdraw heatmap and F8 cycles the
+// opaque draw order
+bool overdrawHeatmap = false;
+OpaqueOrder opaqueOrder = OpaqueOrder::FRONT_TO_BACK;
+// F9 toggles the DebugDraw overlay, see drawDebugOverlay
 
-std::map<GLchar, Character> Characters;
+// F10 takes a screenshot, F11 starts and stops recording
+unsigned int screenshotCount = 0;
+bool recording = false;
+
+// written by the framebuffer size callback, forwarded to the renderer
+// with every frame
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
 
 //lanes
 const std::vector<float> lanes = {-0.5f, 0.0f, 0.5f};
@@ -73,17 +70,267 @@ bool downKeyPressed = false;
 
 float groundLevel = -0.1f;
 
-// camera
-static Camera camera(glm::vec3(0.0f, 0.5f, 2.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, -5.0f);
+// lighting: torches alternate between the walls at this spacing
+const float torchSpacing = 1.15f;
+const glm::vec3 torchColor(1.0f, 0.62f, 0.3f);
 
-//player
-static Player player(lanes, 1, laneSwitchSpeed, jumpSpeed, crouchSpeed);
+// particle effects
+const float dustRate = 3000.0f; // particles per second while the ball rolls
+float dustBudget = 0.0f;
+bool impactEmitted = false;
 
 // timing
 static float deltaTime = 0.0f; // time between current frame and last frame
 static float lastFrame = 0.0f;
+// the simulation always advances in steps of this size, independent of the
+// frame rate; rendering interpolates between the last two steps
+const double simulationStep = 1.0 / 120.0;
+
+// render thread
+// -------------
+// The main thread owns the window, input and simulation and publishes one
+// RenderFrame per iteration. The render thread owns the GL context, turns
+// the newest frame into GL calls and swaps. While the driver works through
+// frame N the main thread already simulates and records frame N + 1.
+enum class RenderState { STARTING, READY, FAILED };
+
+TripleBuffer<RenderFrame> renderFrames;
+// scratch memory of the main thread, reset at the top of every iteration;
+// what goes to the render thread uses the frame's own arena instead
+FrameArena frameArena(64 * 1024, "main");
+std::atomic<RenderState> renderState(RenderState::STARTING);
+std::atomic<bool> renderRunning(true);
+
+void renderLoop(GLFWwindow *window, float segmentLength, int coinCapacity, int width, int height,
+                SwapMode initialSwapMode) {
+    glfwMakeContextCurrent(window);
+
+    // glad: load all OpenGL function pointers
+    // ---------------------------------------
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        glfwMakeContextCurrent(nullptr);
+        renderState = RenderState::FAILED;
+        return;
+    }
+
+    Renderer renderer(groundLevel, segmentLength, coinCapacity, width, height, initialSwapMode, frameCap);
+    renderState = renderer.isReady() ? RenderState::READY : RenderState::FAILED;
+
+    while (renderer.isReady() && renderRunning) {
+        if (!renderFrames.acquire()) {
+            // bounded, so a quit request is noticed even without new frames
+            renderFrames.waitForPublish(std::chrono::milliseconds(5));
+            continue;
+        }
+        const RenderFrame &frame = renderFrames.front();
+        renderer.render(frame);
+        renderer.present(window, frame);
+    }
+
+    renderer.release();
+    glfwMakeContextCurrent(nullptr);
+}
+
+// nearest first, so the depth test rejects hidden fragments before they
+// are shaded; ties keep their order, so draws sharing a model keep their
+// relative order. Sorts keys in the arena instead of using std::stable_sort,
+// which takes its buffer from the heap on every call.
+void sortFrontToBack(std::vector<DrawCommand> &draws, const glm::vec3 &eye, FrameArena &arena) {
+    struct SortKey {
+        float distance;
+        std::uint32_t index;
+    };
+    ArenaAllocator<SortKey> keyAllocator(arena);
+    FrameVector<SortKey> keys(keyAllocator);
+    keys.reserve(draws.size());
+    for (std::size_t i = 0; i < draws.size(); i++) {
+        glm::vec3 toDraw = glm::vec3(draws[i].model[3]) - eye;
+        SortKey key = {glm::dot(toDraw, toDraw), static_cast<std::uint32_t>(i)};
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end(), [](const SortKey &a, const SortKey &b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+    });
+
+    ArenaAllocator<DrawCommand> drawAllocator(arena);
+    FrameVector<DrawCommand> sorted(drawAllocator);
+    sorted.reserve(draws.size());
+    for (const SortKey &key : keys) {
+        sorted.push_back(draws[key.index]);
+    }
+    std::copy(sorted.begin(), sorted.end(), draws.begin());
+}
+
+// dust behind the rolling ball and a burst of splinters and dust where it
+// hit; only emitters are recorded, the particles themselves live on the GPU
+void emitParticles(const Simulation &simulation, const SimulationSnapshot &state, float dt,
+                   std::vector<ParticleEmission> &emissions) {
+    if (!simulation.gameOver) {
+        // only while the ball touches the path, not mid-jump
+        if (state.playerPosition.y < 0.05f) {
+            dustBudget += dustRate * dt;
+            int count = static_cast<int>(dustBudget);
+            dustBudget -= count;
+            if (count > 0) {
+                ParticleEmission dust = {state.playerPosition + glm::vec3(0.0f, -0.09f, 0.0f), 0.04f,
+                                         glm::vec3(0.0f, 0.35f, 0.3f), glm::vec3(0.3f, 0.25f, 0.3f),
+                                         1.2f, count, PARTICLE_DUST};
+                emissions.push_back(dust);
+            }
+        }
+    } else if (!impactEmitted) {
+        impactEmitted = true;
+        ParticleEmission splinters = {simulation.collisionPoint, 0.05f, glm::vec3(0.0f, 1.0f, 0.5f),
+                                      glm::vec3(1.2f, 0.8f, 1.2f), 1.5f, 20000, PARTICLE_SPLINTER};
+        ParticleEmission cloud = {simulation.collisionPoint, 0.1f, glm::vec3(0.0f, 0.3f, 0.2f),
+                                  glm::vec3(0.5f, 0.3f, 0.5f), 2.5f, 10000, PARTICLE_DUST};
+        emissions.push_back(splinters);
+        emissions.push_back(cloud);
+    }
+}
+
+// collision boxes exactly as the simulation tests them, segment bounds and
+// lane centers; the player box follows the interpolated ball so it does not
+// jitter against it
+void drawDebugOverlay(const Simulation &simulation, const SimulationSnapshot &state) {
+    const std::uint32_t playerColor = simulation.gameOver ? DebugDraw::rgba(1.0f, 0.0f, 0.0f)
+                                                          : DebugDraw::rgba(0.0f, 1.0f, 0.0f);
+    const std::uint32_t obstacleColor = DebugDraw::rgba(1.0f, 0.5f, 0.0f);
+    const std::uint32_t segmentColor = DebugDraw::rgba(0.0f, 1.0f, 1.0f);
+    const std::uint32_t laneColor = DebugDraw::rgba(1.0f, 1.0f, 0.0f);
+
+    CollisionDetector playerBox;
+    playerBox.getPlayer(simulation.player, simulation.groundLevel);
+    glm::vec3 offset = state.playerPosition - simulation.player.GetPosition();
+    DebugDraw::box(playerBox.getMin() + offset, playerBox.getMax() + offset, playerColor);
+
+    const ObstacleStore &obstacles = simulation.obstacles;
+    ObstacleStore::Range ranges[2];
+    int rangeCount = obstacles.liveRanges(ranges);
+    for (int r = 0; r < rangeCount; r++) {
+        for (int i = ranges[r].begin; i < ranges[r].end; i++) {
+            DebugDraw::box(glm::vec3(obstacles.minX()[i], obstacles.minY()[i], obstacles.minZ()[i]),
+                           glm::vec3(obstacles.maxX()[i], obstacles.maxY()[i], obstacles.maxZ()[i]), obstacleColor);
+        }
+    }
+
+    // slightly above the path so the lines do not z-fight with it
+    float y = simulation.groundLevel + 0.005f;
+    float nearZ = simulation.segmentZ[0];
+    float farZ = simulation.segmentZ[0];
+    for (int i = 0; i < simulation.numSegments; i++) {
+        float start = simulation.segmentZ[i];
+        float end = start - simulation.segmentLength;
+        DebugDraw::line(glm::vec3(-0.7f, y, start), glm::vec3(0.7f, y, start), segmentColor);
+        DebugDraw::line(glm::vec3(-0.7f, y, start), glm::vec3(-0.7f, y, end), segmentColor);
+        DebugDraw::line(glm::vec3(0.7f, y, start), glm::vec3(0.7f, y, end), segmentColor);
+        nearZ = std::max(nearZ, start);
+        farZ = std::min(farZ, end);
+    }
+    for (float lane : simulation.lanes) {
+        DebugDraw::line(glm::vec3(lane, y, nearZ), glm::vec3(lane, y, farZ), laneColor);
+    }
+}
+
+// records the draw commands of one frame from the simulation and the
+// interpolated snapshot, the main thread's half of the old render code
+void buildRenderFrame(const Simulation &simulation, const SimulationSnapshot &state, bool showEndScreen,
+                      RenderFrame &frame) {
+    frame.clear();
+
+    const Camera &camera = simulation.camera;
+    frame.view = glm::lookAt(state.cameraPosition, state.cameraPosition + camera.Front, camera.Up);
+    // pass projection matrix to shader
+    frame.projection = glm::perspective(glm::radians(camera.Zoom), static_cast<float>(SCR_WIDTH) / SCR_HEIGHT,
+                                        0.2f, 100.0f);
+    frame.cameraPosition = state.cameraPosition;
+    frame.time = simulation.time;
+    frame.textProjection = glm::ortho(0.0f, static_cast<float>(SCR_WIDTH), 0.0f, static_cast<float>(SCR_HEIGHT));
+    frame.endScreen = showEndScreen;
+
+    if (showEndScreen) {
+        //end screen
+        DrawCommand endQuad = {MeshId::END_SCREEN, TextureId::NONE, glm::vec3(0.0f, 0.0f, 0.0f),
+                               glm::translate(glm::mat4(1.0f), state.cameraPosition + camera.Front * 1.0f)};
+        frame.draws.push_back(endQuad);
+
+        TextCommand gameOver = {"GAME OVER", glm::vec2(120.0f, 400.0f), 2.0f, glm::vec3(1.0, 0.0f, 0.0f)};
+        frame.texts.push_back(gameOver);
+        return;
+    }
 
-int main() {
+    for (int i = 0; i < simulation.numSegments; i++) {
+        DrawCommand path = {MeshId::PATH_SEGMENT, TextureId::PATH, glm::vec3(1.0f, 0.0f, 0.0f),
+                            glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, simulation.segmentZ[i]))};
+        frame.draws.push_back(path);
+    }
+
+    for (int i = 0; i < simulation.numSegments; i++) {
+        DrawCommand wall = {MeshId::WALL_SEGMENT, TextureId::WALL, glm::vec3(0.0f, 0.0f, 1.0f),
+                            glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, simulation.segmentZ[i]))};
+        frame.draws.push_back(wall);
+    }
+
+    glm::vec3 obstacleColor(1.0f, 0.8f, 1.0f);
+    const ObstacleStore &obstacles = simulation.obstacles;
+    const ObstacleKind *kinds = obstacles.kinds();
+    const float *obstacleX = obstacles.positionX();
+    const float *obstacleZ = obstacles.positionZ();
+    ObstacleStore::Range ranges[2];
+    int rangeCount = obstacles.liveRanges(ranges);
+    for (int r = 0; r < rangeCount; r++) {
+        for (int i = ranges[r].begin; i < ranges[r].end; i++) {
+            const ObstacleTraits &traits = obstacleTraits(kinds[i]);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(obstacleX[i], 0.0f, obstacleZ[i]));
+            for (int m = 0; m < traits.meshCount; m++) {
+                DrawCommand draw = {traits.meshes[m], traits.textures[m], obstacleColor, model};
+                frame.draws.push_back(draw);
+            }
+        }
+    }
+
+    // torches are placed by world position rather than by segment slot, so
+    // the left/right pattern survives segment recycling
+    float nearZ = simulation.segmentZ[0];
+    float farZ = simulation.segmentZ[0];
+    for (int i = 0; i < simulation.numSegments; i++) {
+        nearZ = std::max(nearZ, simulation.segmentZ[i]);
+        farZ = std::min(farZ, simulation.segmentZ[i] - simulation.segmentLength);
+    }
+    for (long n = static_cast<long>(std::ceil(-nearZ / torchSpacing)); n * torchSpacing <= -farZ; n++) {
+        float flicker = 1.0f + 0.15f * std::sin(simulation.time * 11.0f + n * 1.7f) *
+                                      std::sin(simulation.time * 7.3f + n * 0.9f);
+        PointLight torch = {glm::vec3(n % 2 ? 0.62f : -0.62f, 0.45f, -n * torchSpacing), 1.6f, torchColor,
+                            1.2f * flicker};
+        frame.lights.push_back(torch);
+    }
+    PointLight ballLight = {state.playerPosition + glm::vec3(0.0f, 0.3f, 0.15f), 1.0f,
+                            glm::vec3(1.0f, 0.95f, 0.85f), 0.8f};
+    frame.lights.push_back(ballLight);
+
+    glm::mat4 modelPlayer = glm::translate(glm::mat4(1.0f), state.playerPosition);
+    modelPlayer = glm::rotate(modelPlayer, glm::radians(state.playerRotationAngle), glm::vec3(-1.0f, 0.0f, 0.0f));
+    DrawCommand ball = {MeshId::BALL, TextureId::BALL, glm::vec3(0.82, 0.71, 0.55), modelPlayer};
+    frame.draws.push_back(ball);
+
+    const char *scoreText = frame.arena.format("%05d", static_cast<int>(std::abs(state.playerPosition.z)));
+    TextCommand score = {scoreText, glm::vec2(610.0f, 710.0f), 0.9f, glm::vec3(1.0f, 1.0f, 1.0f)};
+    frame.texts.push_back(score);
+    const char *coinText = frame.arena.format("COINS %d", simulation.coinsCollected);
+    TextCommand coinCount = {coinText, glm::vec2(20.0f, 710.0f), 0.9f, glm::vec3(1.0f, 0.8f, 0.2f)};
+    frame.texts.push_back(coinCount);
+
+    if (opaqueOrder != OpaqueOrder::SUBMISSION) {
+        sortFrontToBack(frame.draws, state.cameraPosition, frameArena);
+    }
+
+    if (DebugDraw::isEnabled()) {
+        drawDebugOverlay(simulation, state);
+    }
+}
+
+int main(int argc, char **argv) {
   // glfw: initialize and configure
   // ------------------------------
   glfwInit();
@@ -109,8 +356,8 @@ int main() {
   }
 
 
-  glfwMakeContextCurrent(window);
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+  glfwSetKeyCallback(window, key_callback);
   //glfwSetCursorPosCallback(window, mouse_callback); //turn this off, only for debugging
   glfwSetInputMode(window, GLFW_REPEAT, GLFW_FALSE);
 //  glfwSetScrollCallback(window, scroll_callback);
@@ -118,848 +365,111 @@ int main() {
   // tell GLFW to capture our mouse
   glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-  // glad: load all OpenGL function pointers
-  // ---------------------------------------
-  if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
-    std::cout << "Failed to initialize GLAD" << std::endl;
-    return -1;
-  }
-
-
-  // configure global opengl state
-  // -----------------------------
-  glEnable(GL_DEPTH_TEST);
-
-  // build and compile our shader program
-  // ------------------------------------
-  std::string shader_location("../res/shaders/");
-  std::string used_shaders("shader");
-  Shader ourShader(shader_location + used_shaders + std::string(".vert"),
-                   shader_location + used_shaders + std::string(".frag"));
-
-    Shader textShader(shader_location + std::string("text.vert"),
-                      shader_location + std::string("text.frag"));
-
-
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    FT_Library ft;
-    // All functions return a value different than 0 whenever an error occurred
-    if (FT_Init_FreeType(&ft))
-    {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-        return -1;
-    }
-
-    FT_Face face;
-    if (FT_New_Face(ft, "../res/fonts/arial.ttf", 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-        return -1;
-    }
-    else {
-        // set size to load glyphs as
-        FT_Set_Pixel_Sizes(face, 0, 48);
-
-        // disable byte-alignment restriction
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-        // load first 128 characters of ASCII set
-        for (unsigned char c = 0; c < 128; c++)
-        {
-            // Load character glyph
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-            {
-                std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-                continue;
-            }
-            // generate texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    GL_RED,
-                    face->glyph->bitmap.width,
-                    face->glyph->bitmap.rows,
-                    0,
-                    GL_RED,
-                    GL_UNSIGNED_BYTE,
-                    face->glyph->bitmap.buffer
-            );
-            // set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // now store character for later use
-            Character character = {
-                    texture,
-                    glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-                    glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-                    static_cast<unsigned int>(face->glyph->advance.x)
-            };
-            Characters.insert(std::pair<char, Character>(c, character));
-        }
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
-
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
     float startZ = 3.0f;
     float length = 23.0f;
     int numSegments = 10;
-
-    std::vector<float> pathVertices;
-    std::vector<unsigned int> pathIndices;
-
-    for(int i = 0; i < numSegments; i++){
-        pathVertices.push_back(-0.7f);
-        pathVertices.push_back(groundLevel);
-        pathVertices.push_back(startZ - (i + 1) * length / numSegments);
-        pathVertices.push_back(0.0f);
-        pathVertices.push_back(1.0f);
-
-        pathVertices.push_back(0.7f);
-        pathVertices.push_back(groundLevel);
-        pathVertices.push_back(startZ - (i + 1) * length / numSegments);
-        pathVertices.push_back(1.0f);
-        pathVertices.push_back(1.0f);
-
-        pathVertices.push_back(-0.7f);
-        pathVertices.push_back(groundLevel);
-        pathVertices.push_back(startZ - i * length / numSegments);
-        pathVertices.push_back(0.0f);
-        pathVertices.push_back(0.0f);
-
-        pathVertices.push_back(0.7f);
-        pathVertices.push_back(groundLevel);
-        pathVertices.push_back(startZ - i * length / numSegments);
-        pathVertices.push_back(1.0f);
-        pathVertices.push_back(0.0f);
-
-
-        pathIndices.push_back(i * 4);//0
-        pathIndices.push_back(i * 4 + 1);//1
-        pathIndices.push_back(i * 4 + 2);//2
-        pathIndices.push_back(i * 4 + 1);//1
-        pathIndices.push_back(i * 4 + 2);//2
-        pathIndices.push_back(i * 4 + 3);//3
-
+    // a segment carries one chunk of up to Chunk::MAX_OBSTACLES, and at most
+    // numSegments + 2 chunks are live: the path, the segment just left
+    // behind and one spawned early through the half chunk of slack. That is
+    // 48 obstacles, the rest is headroom
+    int obstacleCapacity = 256;
+    // at most two trails of 9 coins per segment are live, the rest is headroom
+    int coinCapacity = 1024;
+    // the track is a function of the seed alone, pass one to replay a run
+    std::uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::random_device()();
+    std::cout << "RUN::SEED " << seed << std::endl;
+
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+
+    // the context is never current on the main thread, the render thread
+    // loads everything and then waits for frames
+    std::thread renderThread(renderLoop, window, length / numSegments, coinCapacity, framebufferWidth,
+                             framebufferHeight, swapMode);
+    while (renderState == RenderState::STARTING) {
+        // keep the window responsive while textures load
+        glfwWaitEventsTimeout(0.01);
     }
-
-    unsigned int pathVAO, pathVBO, pathEBO;
-    glGenVertexArrays(1, &pathVAO);
-    glGenBuffers(1, &pathVBO);
-    glGenBuffers(1, &pathEBO);
-
-    glBindVertexArray(pathVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, pathVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * pathVertices.size(), &pathVertices[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pathEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * pathIndices.size(), &pathIndices[0], GL_STATIC_DRAW);
-
-// Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-// Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-
-    std::vector<float> wallVerticess;
-    std::vector<unsigned int> wallIndicess;
-
-    for(int i = 0; i < numSegments; i++){
-        //left wall
-        wallVerticess.push_back(-0.7f);
-        wallVerticess.push_back(5.0f);
-        wallVerticess.push_back(startZ - (i+1) * length / numSegments);
-        wallVerticess.push_back(1.0f);
-        wallVerticess.push_back(5.0f);
-
-        wallVerticess.push_back(-0.7f);
-        wallVerticess.push_back(groundLevel);
-        wallVerticess.push_back(startZ - (i+1) * length / numSegments);
-        wallVerticess.push_back(1.0f);
-        wallVerticess.push_back(0.0f);
-
-        wallVerticess.push_back(-0.7f);
-        wallVerticess.push_back(5.0f);
-        wallVerticess.push_back(startZ - i * length / numSegments);
-        wallVerticess.push_back(0.0f);
-        wallVerticess.push_back(5.0f);
-
-        wallVerticess.push_back(-0.7f);
-        wallVerticess.push_back(groundLevel);
-        wallVerticess.push_back(startZ - i * length / numSegments);
-        wallVerticess.push_back(0.0f);
-        wallVerticess.push_back(0.0f);
-
-        //right wall
-        wallVerticess.push_back(0.7f);
-        wallVerticess.push_back(5.0f);
-        wallVerticess.push_back(startZ - (i+1) * length / numSegments);
-        wallVerticess.push_back(0.0f);
-        wallVerticess.push_back(5.0f);
-
-        wallVerticess.push_back(0.7f);
-        wallVerticess.push_back(groundLevel);
-        wallVerticess.push_back(startZ - (i+1) * length / numSegments);
-        wallVerticess.push_back(0.0f);
-        wallVerticess.push_back(0.0f);
-
-        wallVerticess.push_back(0.7f);
-        wallVerticess.push_back(5.0f);
-        wallVerticess.push_back(startZ - i * length / numSegments);
-        wallVerticess.push_back(1.0f);
-        wallVerticess.push_back(5.0f);
-
-        wallVerticess.push_back(0.7f);
-        wallVerticess.push_back(groundLevel);
-        wallVerticess.push_back(startZ - i * length / numSegments);
-        wallVerticess.push_back(1.0f);
-        wallVerticess.push_back(0.0f);
-
-        //left wall
-        wallIndicess.push_back(i*8);//0
-        wallIndicess.push_back(i*8+1);//1
-        wallIndicess.push_back(i*8+2);//2
-        wallIndicess.push_back(i*8+1);//1
-        wallIndicess.push_back(i*8+2);//2
-        wallIndicess.push_back(i*8+3);//3
-
-        //right wall
-        wallIndicess.push_back(i*8+4);//0
-        wallIndicess.push_back(i*8+5);//1
-        wallIndicess.push_back(i*8+6);//2
-        wallIndicess.push_back(i*8+5);//1
-        wallIndicess.push_back(i*8+6);//2
-        wallIndicess.push_back(i*8+7);//3
-    }
-
-    unsigned int wallVAO, wallVBO, wallEBO;
-    glGenVertexArrays(1, &wallVAO);
-    glGenBuffers(1, &wallVBO);
-    glGenBuffers(1, &wallEBO);
-
-    glBindVertexArray(wallVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, wallVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * wallVerticess.size(), &wallVerticess[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, wallEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * wallIndicess.size(), &wallIndicess[0], GL_STATIC_DRAW);
-
-// Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-// Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-
-
-    const int sectorCount = 360; //horizontal slices
-    const int stackCount = sectorCount / 2; //vertical slices
-    const float radius = 0.1f;
-
-    std::vector<float> playerVertices;
-    for (int i = 0; i <= stackCount; ++i) {
-        float stackAngle = M_PI / 2 - i * M_PI / stackCount;  //phi
-        float xy = radius * cos(stackAngle);
-        float z = radius * sin(stackAngle);
-
-        for (int j = 0; j <= sectorCount; ++j) {
-            float sectorAngle = j * 2 * M_PI / sectorCount; //theta
-            float x = xy * cos(sectorAngle);
-            float y = xy * sin(sectorAngle);
-
-            playerVertices.push_back(x);
-            playerVertices.push_back(y);
-            playerVertices.push_back(z);
-
-            float s = (float)j / sectorCount;
-            float t = (float)i / stackCount;
-            playerVertices.push_back(s);
-            playerVertices.push_back(t);
-        }
-    }
-
-    unsigned int playerVAO, playerVBO;
-    glGenVertexArrays(1, &playerVAO);
-    glGenBuffers(1, &playerVBO);
-
-    glBindVertexArray(playerVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, playerVBO);
-    glBufferData(GL_ARRAY_BUFFER, playerVertices.size() * sizeof(float ), &playerVertices[0], GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-// Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    //obstacle preparation
-    float playerStartPos = player.GetPosition().z;
-    float segmentLength = length/numSegments;
-    unsigned int pointer = 0;
-    float endZ = startZ - length;
-
-    //obstacle random preparation
-    std::random_device rd;  // Obtain a random number from hardware
-    std::mt19937 gen(rd()); // Seed the generator
-    std::uniform_int_distribution<> disX(0, 2);
-    std::uniform_int_distribution<> disObstacle(0, 3); //0-trunk 1-down trunk 2-up trunk 3-empty
-
-    int numberOfObstacles = numSegments / 2;
-    unsigned int pointerObstacle = 0;
-
-    std::vector<float> zCoordinates;
-    std::vector<int> lanesIndexes;
-    std::vector<int> obstaclesTypes;
-
-    float start = endZ/2;
-    float end = endZ;
-
-    for (int i = 0; i < numberOfObstacles; i++) {
-        obstaclesTypes.push_back(disObstacle(gen));
-    }
-
-    float stepZ = (end - start) / numberOfObstacles;
-
-    for (int i = 0; i < numberOfObstacles; i++) {
-            if (obstaclesTypes[i] != 3) {
-                std::uniform_real_distribution<> disZ(start + i * stepZ, start + (i + 1) * stepZ);
-                zCoordinates.push_back(disZ(gen));
-                if (obstaclesTypes[i] == 0) {
-                    lanesIndexes.push_back(disX(gen));
-                } else {
-                    lanesIndexes.push_back(1);
-                }
-            } else {
-                zCoordinates.push_back(0.0f);
-                lanesIndexes.push_back(1);
-            }
-    }
-    std::vector<float> obstacleVertices;
-
-    //tree trunks
-    int n = 130;
-    float r = 0.1f;
-    float xc=0.0f, yc=groundLevel, zc=0.0f;
-    float angle = 0.0f;
-    float delta_angle = 2*M_PI/n;
-    float topyc = 0.2;
-
-    obstacleVertices.push_back(xc);
-    obstacleVertices.push_back(topyc);
-    obstacleVertices.push_back(zc);
-
-    obstacleVertices.push_back(0.5f); //middle 0.5,0.5 from texture
-    obstacleVertices.push_back(0.5f);
-
-    for (int i=0; i<n+1; i++) {
-        obstacleVertices.push_back(xc+r*cos(angle));
-        obstacleVertices.push_back(topyc);
-        obstacleVertices.push_back(zc+r*sin(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(0.5 + 0.5*cos(angle));
-        obstacleVertices.push_back(0.5 + 0.5*sin(angle));
-    }
-
-    for (int i=0; i<n+1; i++) {
-        obstacleVertices.push_back(xc+r*cos(angle));
-        obstacleVertices.push_back(topyc);
-        obstacleVertices.push_back(zc+r*sin(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*1.0/n); //vertices from the top line
-        obstacleVertices.push_back(1.0f);
-
-        obstacleVertices.push_back(xc+r*cos(angle));
-        obstacleVertices.push_back(yc);
-        obstacleVertices.push_back(zc+r*sin(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*1.0/n); //vertices from bottom line
-        obstacleVertices.push_back(0.0f);
-    }
-
-//down fallen trunk
-    float r_down = 0.1f;
-    float leftXc=-0.6f, rightXc = 0.6f, yc_down=groundLevel+radius;
-    angle = 0.0f;
-
-    for (int i=0; i<n+1; i++) {
-        obstacleVertices.push_back(leftXc);
-        obstacleVertices.push_back(yc_down+r_down*sin(angle));
-        obstacleVertices.push_back(zc+r_down*cos(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*5.0/n);
-        obstacleVertices.push_back(5.0f);
-
-        obstacleVertices.push_back(rightXc);
-        obstacleVertices.push_back(yc_down+r_down*sin(angle));
-        obstacleVertices.push_back(zc+r_down*cos(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*5.0/n);
-        obstacleVertices.push_back(0.0f);
-    }
-
-//up fallen trunk
-
-    float leftXcUp=-0.7f, rightXcUp = 0.7f, ycUp=0.3f;
-    angle = 0.0f;
-    delta_angle = 2*M_PI/n;
-
-    for (int i=0; i<n+1; i++) {
-        obstacleVertices.push_back(leftXcUp);
-        obstacleVertices.push_back(ycUp+r_down*sin(angle));
-        obstacleVertices.push_back(zc+r_down*cos(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*5.0/n);
-        obstacleVertices.push_back(5.0f);
-
-        obstacleVertices.push_back(rightXcUp);
-        obstacleVertices.push_back(ycUp+r_down*sin(angle));
-        obstacleVertices.push_back(zc+r_down*cos(angle));
-        angle+=delta_angle;
-
-        obstacleVertices.push_back(i*5.0/n);
-        obstacleVertices.push_back(0.0f);
+    if (renderState == RenderState::FAILED) {
+        renderThread.join();
+        glfwTerminate();
+        return -1;
     }
 
-    unsigned int obstacleVAO, obstacleVBO;
-    glGenVertexArrays(1, &obstacleVAO);
-    glGenBuffers(1, &obstacleVBO);
-
-    glBindVertexArray(obstacleVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, obstacleVBO);
-    glBufferData(GL_ARRAY_BUFFER, obstacleVertices.size() * sizeof(float), &obstacleVertices[0], GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-// Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    float endScreenVertices[] = {
-            // positions     // texCoords
-            -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,  // Top-left
-            -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,  // Bottom-left
-            1.0f, -1.0f, 0.0f,  1.0f, 0.0f,  // Bottom-right
-            1.0f,  1.0f, 0.0f,  1.0f, 1.0f   // Top-right
-    };
-
-    unsigned int endScreenIndices[] = {
-            0, 1, 2, // First triangle
-            2, 3, 0  // Second triangle
-    };
-
-    unsigned int quadVAO, quadVBO, quadEBO;
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glGenBuffers(1, &quadEBO);
-
-    glBindVertexArray(quadVAO);
+    Simulation simulation(lanes, laneSwitchSpeed, jumpSpeed, crouchSpeed, groundLevel, startZ, length, numSegments,
+                          obstacleCapacity, coinCapacity, static_cast<float>(simulationStep), seed);
+    FixedTimestep fixedTimestep(simulationStep);
 
-// Vertex Buffer Object
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(endScreenVertices), endScreenVertices, GL_STATIC_DRAW);
-
-// Element Buffer Object
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(endScreenIndices), endScreenIndices, GL_STATIC_DRAW);
-
-// Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),static_cast<void *>(nullptr));
-    glEnableVertexAttribArray(0);
-
-// Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-
-    GLuint diffuseTexturePath = loadTexture("../res/textures/mud_forest_diff_4k_scaled.jpg");
-
-    GLuint diffuseTextureWall = loadTexture("../res/textures/mossy_cobblestone_diff_4k_scaled.jpg");
-
-    GLuint diffuseTextureTrunk = loadTexture("../res/textures/bark_willow_diff_4k.jpg");
-
-    GLuint diffuseTextureCircleTrunk = loadTexture("../res/textures/round_tree.jpg");
-
-    GLuint diffuseTextureFallenTrunk = loadTexture("../res/textures/tree_fallen.jpg");
-
-    GLuint diffuseTextureBall = loadTexture("../res/textures/rock_ball_scaled.jpg");
-
-    ourShader.use();
-
-    glm::vec3 fogColor = glm::vec3(0.5f, 0.5f, 0.5f);
-    float fogStart = 4.0f;
-    float fogEnd = 13.0f;
-
-    // Set fog uniforms
-    ourShader.setVec3("fogColor", fogColor);
-    ourShader.setFloat("fogStart", fogStart);
-    ourShader.setFloat("fogEnd", fogEnd);
-
-    bool gameOver = false;
     bool showEndScreen = false;
-    float collisionTime = 0.0f;;
     const float endScreenDelay = 0.3f; // delay
 
-    float playerRotationAngle = 0.0f;
-    float rotationSpeed = 90.0f;
+    // the render thread never saw the last published frame, its particle
+    // step and emissions still have to reach the GPU
+    bool frameSkipped = false;
 
+    lastFrame = static_cast<float>(glfwGetTime());
     while (!glfwWindowShouldClose(window)) {
         // per-frame time logic
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // everything recorded until the publish below goes into this slot,
+        // including debug shapes emitted by the simulation
+        RenderFrame &frame = renderFrames.back();
+        frameArena.reset();
+        frame.arena.reset();
+        DebugDraw::begin(&frame.debugLines);
+        if (!frameSkipped) {
+            frame.particleDt = 0.0f;
+            frame.particleEmissions.clear();
+            frame.coinUpdates.clear();
+        }
+
         // input
         processInput(window);
-        player.ProcessInput(leftKeyPressed, rightKeyPressed, upKeyPressed, false, deltaTime);
-
-        // endless running
-        camera.ProcessKeyboard(FORWARD, deltaTime);
-        player.MoveForward(2.5f, deltaTime);
-        //2.5f is the speed of the camera moving forward
+        PlayerInput input = {leftKeyPressed, rightKeyPressed, upKeyPressed, downKeyPressed};
 
-        playerRotationAngle += rotationSpeed * deltaTime;
-        if (playerRotationAngle >= 360.0f) {
-            playerRotationAngle -= 360.0f;
+        // simulation
+        int steps = fixedTimestep.advance(deltaTime);
+        for (int i = 0; i < steps; i++) {
+            simulation.step(input, fixedTimestep.getStep());
         }
+        SimulationSnapshot state = simulation.interpolate(fixedTimestep.getAlpha());
 
-        if (gameOver) {
-            // Check if 2 seconds have passed since the collision
-            if (currentFrame - collisionTime >= endScreenDelay) {
+        if (simulation.gameOver) {
+            if (simulation.time - simulation.collisionTime >= endScreenDelay) {
                 showEndScreen = true;
             }
         }
 
-        // collision detection
-        if(gameOver) {
-            //end screen
-            if(showEndScreen) {
-                glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-                ourShader.use();
-                ourShader.setVec3("MyColor", glm::vec3(0.0f, 0.0f, 0.0f));
-
-                ourShader.setBool("useTexture", false);
-                ourShader.setBool("endGame", true);
-
-                // pass projection matrix to shader
-                glm::mat4 projection = glm::perspective(
-                        glm::radians(camera.Zoom), static_cast<float>(SCR_WIDTH) / SCR_HEIGHT,
-                        0.2f, 100.0f);
-                ourShader.setMat4("projection", projection);
-
-                // camera/view transformation
-                glm::mat4 view = camera.GetViewMatrix();
-                ourShader.setMat4("view", view);
-                ourShader.setVec3("cameraPos", camera.Position);
-
-                glBindVertexArray(quadVAO);
-                glm::mat4 modelEnd = glm::mat4(1.0f);
-                glm::vec3 cameraFront = camera.Front;
-                glm::vec3 quadPosition =
-                        camera.Position + cameraFront * 1.0f;
-
-                modelEnd = glm::translate(modelEnd, quadPosition);
-                ourShader.setMat4("model", modelEnd);
-
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-                glEnable(GL_CULL_FACE);
-                glEnable(GL_BLEND);
-                textShader.use();
-
-                // create transformations
-                glm::mat4 projectionText = glm::ortho(0.0f, static_cast<float>(SCR_WIDTH), 0.0f, static_cast<float>(SCR_HEIGHT));
-                glUniformMatrix4fv(glGetUniformLocation(textShader.ID, "projection"), 1, GL_FALSE, glm::value_ptr(projectionText));
-
-                RenderText(textShader, "GAME OVER", 120.0f, 400.0f, 2.0f, glm::vec3(1.0, 0.0f, 0.0f));
-            }
-
-            //break;
-        } else {
-            glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            glDisable(GL_CULL_FACE);
-            glDisable(GL_BLEND);
-            CollisionDetector playerBox = CollisionDetector();
-            playerBox.getPlayer(player, groundLevel);
-            for (int i = 0; i < numberOfObstacles; i++) {
-                if (obstaclesTypes[i] != 3) {
-                    glm::vec3 obstacleVector = glm::vec3(lanes[lanesIndexes[i]], groundLevel, zCoordinates[i]);
-                    CollisionDetector obstacleBox = CollisionDetector();
-                    obstacleBox.getObstacle(obstacleVector, obstaclesTypes[i]);
-
-                    if (playerBox.check(obstacleBox)) {
-                        gameOver = true;
-                        collisionTime = static_cast<float>(glfwGetTime());
-                        break;
-                    }
-                }
-            }
-
-            // activate shader
-            ourShader.use();
-            ourShader.setVec3("MyColor", glm::vec3(1.0f, 0.0f, 0.0f));
-
-            ourShader.setBool("useTexture", true);
-            ourShader.setBool("endGame", false);
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, diffuseTexturePath);
-            ourShader.setInt("diffuseTexture", 0);
-
-            // pass projection matrix to shader
-            glm::mat4 projection = glm::perspective(
-                    glm::radians(camera.Zoom), static_cast<float>(SCR_WIDTH) / SCR_HEIGHT,
-                    0.2f, 100.0f);
-            ourShader.setMat4("projection", projection);
-
-            // camera/view transformation
-            glm::mat4 view = camera.GetViewMatrix();
-            ourShader.setMat4("view", view);
-            ourShader.setVec3("cameraPos", camera.Position);
-
-            glBindVertexArray(pathVAO);
-            glm::mat4 modelPath = glm::mat4(1.0f);
-            ourShader.setMat4("model", modelPath);
-            for (int i = 0; i < numSegments; i++) {
-                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void *) (i * 6 * sizeof(unsigned int)));
-            }
-
-            glBindVertexArray(wallVAO);
-            glm::mat4 modelWall = glm::mat4(1.0f);
-            ourShader.setMat4("model", modelWall);
-            ourShader.setVec3("MyColor", glm::vec3(0.0f, 0.0f, 1.0f));
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, diffuseTextureWall);
-            ourShader.setInt("diffuseTexture", 0);
-            for (int i = 0; i < numSegments; i++) {
-                glDrawElements(GL_TRIANGLES, 12, GL_UNSIGNED_INT, (void *) (i * 12 * sizeof(unsigned int)));
-            }
-
-            if (abs(playerStartPos - player.GetPosition().z) >= segmentLength) {
-                playerStartPos = player.GetPosition().z;
-
-                //20 from drawing
-                pathVertices[pointer * 20 + 2] = endZ - segmentLength;
-                pathVertices[pointer * 20 + 5 + 2] = endZ - segmentLength;
-                pathVertices[pointer * 20 + 10 + 2] = endZ;
-                pathVertices[pointer * 20 + 15 + 2] = endZ;
-
-                //left wall
-                wallVerticess[pointer * 40 + 2] = endZ - segmentLength;
-                wallVerticess[pointer * 40 + 5 + 2] = endZ - segmentLength;
-                wallVerticess[pointer * 40 + 10 + 2] = endZ;
-                wallVerticess[pointer * 40 + 15 + 2] = endZ;
-
-                //right wall
-                wallVerticess[pointer * 40 + 20 + 2] = endZ - segmentLength;
-                wallVerticess[pointer * 40 + 25 + 2] = endZ - segmentLength;
-                wallVerticess[pointer * 40 + 30 + 2] = endZ;
-                wallVerticess[pointer * 40 + 35 + 2] = endZ;
-
-                endZ -= segmentLength;
-
-                if (pointer == numSegments - 1) {
-                    pointer = 0;
-                } else {
-                    pointer++;
-                }
-
-                if (numberOfObstacles < numSegments) {
-                    int obstacleType = disObstacle(gen);
-                    obstaclesTypes.push_back(obstacleType);
-                    if (obstacleType != 3) {
-                        std::uniform_real_distribution<> disZ(endZ + segmentLength, endZ);
-                        zCoordinates.push_back(disZ(gen));
-                        if (obstacleType == 0) {
-                            lanesIndexes.push_back(disX(gen));
-                        } else {
-                            lanesIndexes.push_back(1);
-                        }
-                    } else {
-                        zCoordinates.push_back(0.0f);
-                        lanesIndexes.push_back(1);
-                    }
-
-                    numberOfObstacles++;
-                } else {
-                    int obstacleType = disObstacle(gen);
-                    obstaclesTypes[pointerObstacle] = obstacleType;
-
-                    int previousObstacle, previousPointer;
-                    if (pointerObstacle == 0) {
-                        previousObstacle = obstaclesTypes[numberOfObstacles - 1];
-                        previousPointer = numberOfObstacles - 1;
-                    } else {
-                        previousObstacle = obstaclesTypes[pointerObstacle - 1];
-                        previousPointer = pointerObstacle - 1;
-                    }
-
-                    std::uniform_real_distribution<> disZ(endZ + segmentLength, endZ);
-                    float newZ = disZ(gen);
-                    float distance = 0.7f;
-                    bool tooClose = false;
-                    if ((previousObstacle == 1 || previousObstacle == 2) && (obstacleType == 1 || obstacleType == 2) && abs(newZ - zCoordinates[previousPointer]) <= distance) {
-                        tooClose = true;
-                    }
-
-
-                    if (obstacleType != 3 && !tooClose) {
-                        zCoordinates[pointerObstacle] = newZ;
-                        if (obstacleType == 0) {
-                            lanesIndexes[pointerObstacle] = disX(gen);
-                        } else {
-                            lanesIndexes[pointerObstacle] = 1;
-                        }
-                    } else {
-                        zCoordinates[pointerObstacle] = 0.0f;
-                        lanesIndexes[pointerObstacle] = 1;
-                    }
-
-
-                    if (pointerObstacle == numberOfObstacles - 1) {
-                        pointerObstacle = 0;
-                    } else {
-                        pointerObstacle++;
-                    }
-                }
-
-                // Re-upload the updated vertex data to the GPU
-                glBindBuffer(GL_ARRAY_BUFFER, pathVBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(float) * pathVertices.size(), &pathVertices[0], GL_STATIC_DRAW);
-
-                glBindBuffer(GL_ARRAY_BUFFER, wallVBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(float) * wallVerticess.size(), &wallVerticess[0], GL_STATIC_DRAW);
-            }
-
-            ourShader.setVec3("MyColor", glm::vec3(1.0f, 0.8f, 1.0f));
-
-
-            glBindVertexArray(obstacleVAO);
-            for (int i = 0; i < numberOfObstacles; i++) {
-                if (obstaclesTypes[i] != 3) {
-                    glm::mat4 modelObstacle = glm::mat4(1.0f);
-                    if (obstaclesTypes[i] == 0) {
-                        //tree trunk
-                        modelObstacle = glm::translate(modelObstacle,
-                                                       glm::vec3(lanes[lanesIndexes[i]], 0.0f, zCoordinates[i]));
-                    } else {
-                        //fallen tree trunk
-                        modelObstacle = glm::translate(modelObstacle, glm::vec3(0.0f, 0.0f, zCoordinates[i]));
-                    }
-                    ourShader.setMat4("model", modelObstacle);
-                    if (obstaclesTypes[i] == 0) {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, diffuseTextureCircleTrunk);
-                        ourShader.setInt("diffuseTexture", 0);
-
-                        glDrawArrays(GL_TRIANGLE_FAN, 0, n + 2);
-
-
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, diffuseTextureTrunk);
-                        ourShader.setInt("diffuseTexture", 0);
-
-                        glDrawArrays(GL_TRIANGLE_STRIP, n + 2, 2 * (n + 1));
-                    } else if (obstaclesTypes[i] == 1) {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, diffuseTextureFallenTrunk);
-                        ourShader.setInt("diffuseTexture", 0);
-
-                        glDrawArrays(GL_TRIANGLE_STRIP, n + 2 + 2 * (n + 1), 2 * (n + 1));
-                    } else {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, diffuseTextureFallenTrunk);
-                        ourShader.setInt("diffuseTexture", 0);
-
-                        glDrawArrays(GL_TRIANGLE_STRIP, n + 2 + 2 * 2 * (n + 1), 2 * (n + 1));
-                    }
-                }
-            }
-
-            ourShader.setVec3("MyColor", glm::vec3(0.82, 0.71, 0.55));
-
-            glBindVertexArray(playerVAO);
-            glm::mat4 modelPlayer = glm::mat4(1.0f);
-            modelPlayer = glm::translate(modelPlayer, player.GetPosition());
-
-            modelPlayer = glm::rotate(modelPlayer, glm::radians(playerRotationAngle), glm::vec3(-1.0f, 0.0f, 0.0f));
-
-            ourShader.setMat4("model", modelPlayer);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, diffuseTextureBall);
-            ourShader.setInt("diffuseTexture", 0);
-
-            glDrawArrays(GL_LINE_STRIP, 0, sectorCount * stackCount);
-
-
-            glEnable(GL_CULL_FACE);
-            glEnable(GL_BLEND);
-            textShader.use();
-
-            // create transformations
-            glm::mat4 projectionText = glm::ortho(0.0f, static_cast<float>(SCR_WIDTH), 0.0f, static_cast<float>(SCR_HEIGHT));
-            glUniformMatrix4fv(glGetUniformLocation(textShader.ID, "projection"), 1, GL_FALSE, glm::value_ptr(projectionText));
-
-            std::ostringstream timeStream;
-            timeStream << std::setfill('0') << std::setw(5) << static_cast<int>(abs(player.GetPosition().z));
-            std::string timeText = timeStream.str();
-            RenderText(textShader, timeText, 610.0f, 710.0f, 0.9f, glm::vec3(1.0f, 1.0f, 1.0f));
-        }
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+        // record the frame and hand it to the render thread
+        buildRenderFrame(simulation, state, showEndScreen, frame);
+        frame.particleDt += std::min(deltaTime, 0.25f);
+        emitParticles(simulation, state, deltaTime, frame.particleEmissions);
+        frame.coinUpdates.insert(frame.coinUpdates.end(), simulation.coinUpdates.begin(),
+                                 simulation.coinUpdates.end());
+        simulation.coinUpdates.clear();
+        frame.framebufferWidth = framebufferWidth;
+        frame.framebufferHeight = framebufferHeight;
+        frame.swapMode = swapMode;
+        // nobody sees the frames of a minimized window
+        frame.lowPower = lowPowerMode || glfwGetWindowAttrib(window, GLFW_ICONIFIED);
+        frame.overdrawHeatmap = overdrawHeatmap;
+        frame.screenshotCount = screenshotCount;
+        frame.recording = recording;
+        frame.depthPrepass = opaqueOrder == OpaqueOrder::DEPTH_PREPASS;
+        DebugDraw::begin(nullptr);
+        frameSkipped = renderFrames.publish();
+
+        // stay at most one frame ahead of the render thread, which is paced
+        // by the swap, so the simulation runs at the display rate
+        renderFrames.waitForConsumer(std::chrono::milliseconds(50));
+        glfwPollEvents();
 
     }
 
-// optional: de-allocate all resources once they've outlived their purpose:
-// ------------------------------------------------------------------------
-    glDeleteVertexArrays(1, &playerVAO);
-    glDeleteBuffers(1, &playerVBO);
-    glDeleteVertexArrays(1, &pathVAO);
-    glDeleteBuffers(1, &pathVBO);
-    glDeleteBuffers(1, &pathEBO);
-    glDeleteVertexArrays(1, &wallVAO);
-    glDeleteBuffers(1, &wallVBO);
-    glDeleteBuffers(1, &wallEBO);
+    renderRunning = false;
+    renderThread.join();
 
 // glfw: terminate, clearing all previously allocated GLFW resources.
 // ------------------------------------------------------------------
@@ -982,60 +492,56 @@ void processInput(GLFWwindow *window) {
     downKeyPressed = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
 }
 
+// glfw: whenever a key is pressed, used for the toggles that must fire once
+// per press rather than every frame the key is held
+// ---------------------------------------------------------------------------------------------
+void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {
+    (void) window; (void) scancode; (void) mods;
+    if (action != GLFW_PRESS)
+        return;
+
+    switch (key) {
+        case GLFW_KEY_F5:
+            swapMode = swapMode == SwapMode::VSYNC ? SwapMode::ADAPTIVE_VSYNC
+                     : swapMode == SwapMode::ADAPTIVE_VSYNC ? SwapMode::IMMEDIATE
+                     : SwapMode::VSYNC;
+            break;
+        case GLFW_KEY_F6:
+            lowPowerMode = !lowPowerMode;
+            break;
+        case GLFW_KEY_F7:
+            overdrawHeatmap = !overdrawHeatmap;
+            break;
+        case GLFW_KEY_F8:
+            opaqueOrder = opaqueOrder == OpaqueOrder::SUBMISSION ? OpaqueOrder::FRONT_TO_BACK
+                        : opaqueOrder == OpaqueOrder::FRONT_TO_BACK ? OpaqueOrder::DEPTH_PREPASS
+                        : OpaqueOrder::SUBMISSION;
+            std::cout << "OVERDRAW::ORDER " << (opaqueOrder == OpaqueOrder::SUBMISSION ? "submission"
+                                              : opaqueOrder == OpaqueOrder::FRONT_TO_BACK ? "front to back"
+                                              : "depth pre-pass") << std::endl;
+            break;
+        case GLFW_KEY_F9:
+            DebugDraw::setEnabled(!DebugDraw::isEnabled());
+            break;
+        case GLFW_KEY_F10:
+            screenshotCount++;
+            break;
+        case GLFW_KEY_F11:
+            recording = !recording;
+            break;
+        default:
+            break;
+    }
+}
 
 // glfw: whenever the window size changed (by OS or user resize) this callback
 // function executes
 // ---------------------------------------------------------------------------------------------
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
-  // make sure the viewport matches the new window dimensions; note that width
-  // and height will be significantly larger than specified on retina displays.
-  glViewport(0, 0, width, height);
+  // the render thread picks the new size up with the next frame and sets
+  // the viewport there; note that width and height will be significantly
+  // larger than specified on retina displays.
+  (void) window;
+  framebufferWidth = width;
+  framebufferHeight = height;
 }
-
-// glfw: whenever the mouse moves, this callback is called
-// -------------------------------------------------------
-
-void RenderText(Shader &shader, std::string text, float x, float y, float scale, glm::vec3 color) {
-    // activate corresponding render state
-    shader.use();
-    glUniform3f(glGetUniformLocation(shader.ID, "textColor"), color.x, color.y, color.z);
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(VAO);
-
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = Characters[*c];
-
-        float xpos = x + ch.Bearing.x * scale;
-        float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
-
-        float w = ch.Size.x * scale;
-        float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-                {xpos,     ypos + h, 0.0f, 0.0f},
-                {xpos,     ypos,     0.0f, 1.0f},
-                {xpos + w, ypos,     1.0f, 1.0f},
-
-                {xpos,     ypos + h, 0.0f, 0.0f},
-                {xpos + w, ypos,     1.0f, 1.0f},
-                {xpos + w, ypos + h, 1.0f, 0.0f}
-        };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices),
-                        vertices); // be sure to use glBufferSubData and not glBufferData
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-        x += (ch.Advance >> 6) *
-             scale; // bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
-    }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
@@ -0,0 +1,162 @@
+// Compares overlapBatch with CollisionDetector::check on random boxes.
+// Built once per SIMD path (see CMakeLists.txt); the boxes sit on a coarse
+// grid so touching faces, where inclusive overlap matters, are common.
+
+#include "AabbBatch.hpp"
+#include "AABB_CollisionDetection.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Boxes {
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    AabbColumns columns() const {
+        AabbColumns c = {minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data()};
+        return c;
+    }
+};
+
+int failures = 0;
+
+void fail(const char *what, int begin, int end, int box) {
+    if (failures < 20) {
+        std::printf("ERROR::AABB_BATCH_TEST::%s begin %d end %d box %d\n", what, begin, end, box);
+    }
+    failures++;
+}
+
+float gridCoordinate(std::mt19937 &rng) {
+    return std::uniform_int_distribution<int>(-8, 8)(rng) * 0.25f;
+}
+
+void randomBox(std::mt19937 &rng, glm::vec3 &min, glm::vec3 &max) {
+    for (int axis = 0; axis < 3; axis++) {
+        float a = gridCoordinate(rng);
+        float b = gridCoordinate(rng);
+        min[axis] = a < b ? a : b;
+        max[axis] = a < b ? b : a;
+    }
+}
+
+Boxes randomBoxes(std::mt19937 &rng, int count) {
+    Boxes boxes;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 min, max;
+        randomBox(rng, min, max);
+        boxes.minX.push_back(min.x);
+        boxes.minY.push_back(min.y);
+        boxes.minZ.push_back(min.z);
+        boxes.maxX.push_back(max.x);
+        boxes.maxY.push_back(max.y);
+        boxes.maxZ.push_back(max.z);
+    }
+    return boxes;
+}
+
+void checkRange(const glm::vec3 &min, const glm::vec3 &max, const Boxes &boxes, int begin, int end,
+                std::vector<std::uint64_t> &hitMask) {
+    CollisionDetector query(min, max);
+    int expectedFirst = -1;
+    std::vector<std::uint64_t> expectedMask((end - begin + 63) / 64, 0);
+    for (int i = begin; i < end; i++) {
+        CollisionDetector box(glm::vec3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]),
+                              glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]));
+        if (query.check(box)) {
+            expectedMask[(i - begin) / 64] |= static_cast<std::uint64_t>(1) << ((i - begin) % 64);
+            if (expectedFirst < 0) {
+                expectedFirst = i;
+            }
+        }
+    }
+
+    if (overlapBatch(min, max, boxes.columns(), begin, end, hitMask) != expectedFirst) {
+        fail("FIRST_HIT", begin, end, expectedFirst);
+    }
+    if (hitMask != expectedMask) {
+        fail("HIT_MASK", begin, end, expectedFirst);
+    }
+}
+
+} // namespace
+
+int main() {
+#if defined(AABB_BATCH_EXPECTED_WIDTH)
+#if AABB_BATCH_EXPECTED_WIDTH == 8 && (defined(__GNUC__) || defined(__clang__))
+    if (!__builtin_cpu_supports("avx")) {
+        std::printf("AABB_BATCH_TEST:: skipped, the CPU has no AVX\n");
+        return 0;
+    }
+#endif
+    if (aabbBatchWidth() != AABB_BATCH_EXPECTED_WIDTH) {
+        std::printf("ERROR::AABB_BATCH_TEST::WIDTH built %d, expected %d\n", aabbBatchWidth(),
+                    AABB_BATCH_EXPECTED_WIDTH);
+        return 1;
+    }
+#endif
+
+    std::mt19937 rng(12345u);
+    std::vector<std::uint64_t> hitMask;
+
+    // every start up to two batches in and every length up to three batches
+    // plus a tail, so unaligned starts and ranges shorter than one batch are
+    // all hit on the 8, 4 and 1 wide paths
+    Boxes small = randomBoxes(rng, 48);
+    for (int query = 0; query < 40; query++) {
+        glm::vec3 min, max;
+        randomBox(rng, min, max);
+        for (int begin = 0; begin <= 16; begin++) {
+            for (int end = begin; end <= begin + 27 && end <= static_cast<int>(small.minX.size()); end++) {
+                checkRange(min, max, small, begin, end, hitMask);
+            }
+        }
+    }
+
+    // long ranges spanning several mask words
+    Boxes large = randomBoxes(rng, 300);
+    for (int query = 0; query < 500; query++) {
+        glm::vec3 min, max;
+        randomBox(rng, min, max);
+        int begin = std::uniform_int_distribution<int>(0, 40)(rng);
+        int end = std::uniform_int_distribution<int>(begin, 300)(rng);
+        checkRange(min, max, large, begin, end, hitMask);
+    }
+
+    // an empty or reversed range clears the mask and finds nothing
+    hitMask.assign(3, ~static_cast<std::uint64_t>(0));
+    if (overlapBatch(glm::vec3(-10.0f), glm::vec3(10.0f), large.columns(), 20, 10, hitMask) != -1 ||
+        !hitMask.empty()) {
+        fail("EMPTY_RANGE", 20, 10, -1);
+    }
+
+    // a box touching another only on a face still overlaps, one a hair
+    // away does not
+    Boxes touching;
+    for (int i = 0; i < 9; i++) {
+        float gap = i == 7 ? 0.0f : 0.001f;
+        touching.minX.push_back(1.0f + gap);
+        touching.minY.push_back(0.0f);
+        touching.minZ.push_back(0.0f);
+        touching.maxX.push_back(2.0f);
+        touching.maxY.push_back(1.0f);
+        touching.maxZ.push_back(1.0f);
+    }
+    for (int begin = 0; begin <= 8; begin++) {
+        checkRange(glm::vec3(0.0f), glm::vec3(1.0f), touching, begin, 9, hitMask);
+        int expected = begin <= 7 ? 7 : -1;
+        if (overlapBatch(glm::vec3(0.0f), glm::vec3(1.0f), touching.columns(), begin, 9, hitMask) != expected) {
+            fail("TOUCHING", begin, 9, expected);
+        }
+    }
+
+    if (failures) {
+        std::printf("AABB_BATCH_TEST:: %d failures (width %d)\n", failures, aabbBatchWidth());
+        return 1;
+    }
+    std::printf("AABB_BATCH_TEST:: passed (width %d)\n", aabbBatchWidth());
+    return 0;
+}
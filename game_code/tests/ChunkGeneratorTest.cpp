@@ -0,0 +1,104 @@
+// The track must be a function of the seed alone: two generators with the
+// same seed give the same chunks, obstacles and coins alike, however their
+// worker threads are scheduled, and another seed gives another track.
+
+#include "ChunkGenerator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// the game's values, see main.cpp and Simulation
+const std::vector<float> LANES = {-0.5f, 0.0f, 0.5f};
+const float LANE_SWITCH_SPEED = 7.5f;
+const float JUMP_SPEED = 3.0f;
+const float CROUCH_SPEED = 3.0f;
+const float GROUND_LEVEL = -0.1f;
+const float FORWARD_SPEED = 2.5f;
+const float STEP_SIZE = 1.0f / 120.0f;
+const float CHUNK_LENGTH = 2.3f;
+const float START_DISTANCE = 4.6f;
+const int LOOK_AHEAD = 8;
+const int CHUNKS = 3000;
+
+std::vector<Chunk> generateRun(std::uint64_t seed) {
+    ChunkGenerator generator(LANES, CHUNK_LENGTH, START_DISTANCE, LOOK_AHEAD, seed,
+                             SolvabilityChecker(LANES, LANE_SWITCH_SPEED, JUMP_SPEED, CROUCH_SPEED, GROUND_LEVEL,
+                                                FORWARD_SPEED, STEP_SIZE, CHUNK_LENGTH));
+    std::vector<Chunk> chunks;
+    while (static_cast<int>(chunks.size()) < CHUNKS) {
+        const Chunk *chunk = generator.front();
+        if (!chunk) {
+            std::this_thread::yield();
+            continue;
+        }
+        chunks.push_back(*chunk);
+        generator.pop();
+    }
+    return chunks;
+}
+
+bool sameChunk(const Chunk &a, const Chunk &b) {
+    if (a.startDistance != b.startDistance || a.count != b.count || a.coinCount != b.coinCount) {
+        return false;
+    }
+    for (int i = 0; i < a.count; i++) {
+        if (a.obstacles[i].kind != b.obstacles[i].kind || a.obstacles[i].lane != b.obstacles[i].lane ||
+            a.obstacles[i].distance != b.obstacles[i].distance) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a.coinCount; i++) {
+        if (a.coins[i].lane != b.coins[i].lane || a.coins[i].distance != b.coins[i].distance ||
+            a.coins[i].height != b.coins[i].height) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::vector<Chunk> first = generateRun(42u);
+    std::vector<Chunk> second = generateRun(42u);
+    std::vector<Chunk> other = generateRun(43u);
+
+    int failures = 0;
+    int differentFromOther = 0;
+    int obstacles = 0;
+    int coins = 0;
+    for (int i = 0; i < CHUNKS; i++) {
+        if (!sameChunk(first[i], second[i])) {
+            if (failures < 10) {
+                std::printf("ERROR::CHUNK_GENERATOR_TEST::SAME_SEED chunk %d differs\n", i);
+            }
+            failures++;
+        }
+        if (!sameChunk(first[i], other[i])) {
+            differentFromOther++;
+        }
+        obstacles += first[i].count;
+        coins += first[i].coinCount;
+    }
+
+    // a track without obstacles or coins would pass the comparison trivially
+    if (obstacles == 0 || coins == 0) {
+        std::printf("ERROR::CHUNK_GENERATOR_TEST::EMPTY_TRACK %d obstacles, %d coins\n", obstacles, coins);
+        failures++;
+    }
+    if (differentFromOther == 0) {
+        std::printf("ERROR::CHUNK_GENERATOR_TEST::OTHER_SEED seeds 42 and 43 gave the same track\n");
+        failures++;
+    }
+
+    if (failures) {
+        return 1;
+    }
+    std::printf("CHUNK_GENERATOR_TEST:: passed, %d chunks, %d obstacles, %d coins, %d differ for another seed\n",
+                CHUNKS, obstacles, coins, differentFromOther);
+    return 0;
+}
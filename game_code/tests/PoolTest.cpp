@@ -0,0 +1,173 @@
+// Pool with a move-only element type that owns memory, so destroy has to
+// move the last object into the hole and the live count shows whether
+// every object is destroyed exactly once.
+
+#include "Pool.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char *what) {
+    if (!condition) {
+        std::printf("ERROR::POOL_TEST::%s\n", what);
+        failures++;
+    }
+}
+
+struct Emitter {
+    static int live;
+
+    std::string name;
+    std::unique_ptr<std::vector<int>> particles;
+
+    Emitter(const std::string &name, int count) : name(name), particles(new std::vector<int>(count, count)) {
+        live++;
+    }
+    Emitter(Emitter &&other) : name(std::move(other.name)), particles(std::move(other.particles)) { live++; }
+    Emitter &operator=(Emitter &&other) {
+        name = std::move(other.name);
+        particles = std::move(other.particles);
+        return *this;
+    }
+    ~Emitter() { live--; }
+
+    Emitter(const Emitter &) = delete;
+    Emitter &operator=(const Emitter &) = delete;
+};
+
+int Emitter::live = 0;
+
+void createAndDestroy() {
+    Pool<Emitter> pool(4);
+    expect(pool.empty() && pool.capacity() == 4, "NEW_POOL_NOT_EMPTY");
+
+    PoolHandle fire = pool.create("fire", 3);
+    PoolHandle smoke = pool.create("smoke", 5);
+    expect(fire.valid() && smoke.valid(), "CREATE_INVALID");
+    expect(pool.size() == 2 && Emitter::live == 2, "CREATE_SIZE");
+    expect(pool.get(fire) && pool.get(fire)->name == "fire" && pool.get(fire)->particles->size() == 3,
+           "CREATE_CONTENT");
+
+    expect(pool.destroy(fire), "DESTROY");
+    expect(pool.size() == 1 && Emitter::live == 1, "DESTROY_SIZE");
+    // smoke was the last object and moved into fire's place
+    expect(pool.get(smoke) && pool.get(smoke)->name == "smoke" && pool.get(smoke)->particles->size() == 5,
+           "MOVED_OBJECT");
+    expect(pool.handleAt(0).index == smoke.index && pool.handleAt(0).generation == smoke.generation,
+           "MOVED_HANDLE");
+}
+
+void staleHandles() {
+    Pool<Emitter> pool(2);
+    PoolHandle first = pool.create("first", 1);
+    expect(pool.destroy(first), "DESTROY");
+    expect(!pool.contains(first) && pool.get(first) == nullptr, "STALE_RESOLVES");
+    expect(!pool.destroy(first), "STALE_DESTROYED_TWICE");
+
+    // the free slot is reused with a new generation, the old handle still
+    // does not resolve to the new object
+    PoolHandle second = pool.create("second", 2);
+    expect(second.index == first.index && second.generation != first.generation, "SLOT_REUSE");
+    expect(pool.get(first) == nullptr && pool.get(second) && pool.get(second)->name == "second",
+           "STALE_AFTER_REUSE");
+
+    PoolHandle invalid;
+    expect(!invalid.valid() && !pool.contains(invalid) && pool.get(invalid) == nullptr && !pool.destroy(invalid),
+           "INVALID_HANDLE");
+    PoolHandle outOfRange;
+    outOfRange.index = 7;
+    expect(!pool.contains(outOfRange), "OUT_OF_RANGE_HANDLE");
+}
+
+void fullPool() {
+    Pool<Emitter> pool(3);
+    std::vector<PoolHandle> handles;
+    for (int i = 0; i < 3; i++) {
+        handles.push_back(pool.create("emitter", i));
+    }
+    expect(pool.full(), "NOT_FULL");
+
+    PoolHandle refused = pool.create("refused", 1);
+    expect(!refused.valid() && pool.size() == 3 && pool.getFailedCreates() == 1, "FULL_CREATE");
+    expect(Emitter::live == 3, "FULL_CREATE_CONSTRUCTED");
+
+    expect(pool.destroy(handles[1]), "DESTROY");
+    expect(!pool.full() && pool.create("again", 1).valid(), "CREATE_AFTER_FREE");
+
+    Pool<Emitter> none(0);
+    expect(none.full() && !none.create("none", 1).valid() && none.getFailedCreates() == 1, "ZERO_CAPACITY");
+}
+
+void highWater() {
+    Pool<Emitter> pool(8);
+    std::vector<PoolHandle> handles;
+    for (int i = 0; i < 5; i++) {
+        handles.push_back(pool.create("emitter", i));
+    }
+    for (int i = 0; i < 4; i++) {
+        pool.destroy(handles[i]);
+    }
+    pool.create("emitter", 1);
+    expect(pool.size() == 2 && pool.getHighWater() == 5, "HIGH_WATER");
+}
+
+// random create / destroy against a plain list of what should be alive,
+// after every step the packed objects and handleAt must agree with it
+void denseIteration() {
+    Pool<Emitter> pool(16);
+    std::vector<PoolHandle> alive;
+    std::vector<int> counts;
+    unsigned state = 1u;
+    for (int step = 0; step < 2000; step++) {
+        state = state * 1664525u + 1013904223u;
+        bool destroy = !alive.empty() && ((state >> 16) % 3 == 0 || pool.full());
+        if (destroy) {
+            std::size_t victim = (state >> 8) % alive.size();
+            expect(pool.destroy(alive[victim]), "RANDOM_DESTROY");
+            alive.erase(alive.begin() + victim);
+            counts.erase(counts.begin() + victim);
+        } else {
+            int count = static_cast<int>((state >> 4) % 50);
+            alive.push_back(pool.create("emitter", count));
+            counts.push_back(count);
+        }
+
+        expect(pool.size() == alive.size(), "RANDOM_SIZE");
+        for (std::size_t i = 0; i < alive.size(); i++) {
+            const Emitter *emitter = pool.get(alive[i]);
+            expect(emitter && static_cast<int>(emitter->particles->size()) == counts[i], "RANDOM_CONTENT");
+        }
+        std::uint32_t position = 0;
+        for (const Emitter &emitter : pool) {
+            expect(&emitter == pool.get(pool.handleAt(position)), "DENSE_HANDLE_AT");
+            position++;
+        }
+        if (failures) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    createAndDestroy();
+    staleHandles();
+    fullPool();
+    highWater();
+    denseIteration();
+    expect(Emitter::live == 0, "LEAKED_OBJECTS");
+
+    if (failures) {
+        return 1;
+    }
+    std::printf("POOL_TEST:: passed\n");
+    return 0;
+}
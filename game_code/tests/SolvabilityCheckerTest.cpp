@@ -0,0 +1,145 @@
+// The checker is the only guarantee that a track can be passed. Checks that
+// it accepts every authored pattern after a free run-up from standing,
+// rejects a wall nothing gets through without touching reach, and still
+// sees a wall across a chunk boundary from either side.
+
+#include "ObstaclePatterns.hpp"
+#include "SolvabilityChecker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// the game's values, see main.cpp and Simulation
+const std::vector<float> LANES = {-0.5f, 0.0f, 0.5f};
+const float LANE_SWITCH_SPEED = 7.5f;
+const float JUMP_SPEED = 3.0f;
+const float CROUCH_SPEED = 3.0f;
+const float GROUND_LEVEL = -0.1f;
+const float FORWARD_SPEED = 2.5f;
+const float STEP_SIZE = 1.0f / 120.0f;
+const float CHUNK_LENGTH = 2.3f;
+const float START_DISTANCE = 5 * CHUNK_LENGTH;
+
+int failures = 0;
+
+void expect(bool condition, const char *what, int pattern) {
+    if (!condition) {
+        std::printf("ERROR::SOLVABILITY_CHECKER_TEST::%s pattern %d\n", what, pattern);
+        failures++;
+    }
+}
+
+SolvabilityChecker makeChecker() {
+    return SolvabilityChecker(LANES, LANE_SWITCH_SPEED, JUMP_SPEED, CROUCH_SPEED, GROUND_LEVEL, FORWARD_SPEED,
+                              STEP_SIZE, CHUNK_LENGTH);
+}
+
+// the pattern laid out the way ChunkGenerator::build does it
+std::vector<ObstacleSpawn> layOut(const ObstaclePattern &pattern, float startDistance, float shift, int lane) {
+    std::vector<ObstacleSpawn> obstacles;
+    for (int i = 0; i < pattern.count; i++) {
+        const PatternSpawn &spawn = pattern.spawns[i];
+        ObstacleSpawn obstacle;
+        obstacle.kind = spawn.kind;
+        obstacle.lane = spawn.lane != KIND_LANE ? spawn.lane : obstacleTraits(spawn.kind).lane;
+        if (obstacle.lane == ANY_LANE) {
+            obstacle.lane = lane;
+        }
+        obstacle.distance = startDistance + CHUNK_LENGTH * std::min(std::max(spawn.offset + shift, 0.0f), 1.0f);
+        obstacles.push_back(obstacle);
+    }
+    return obstacles;
+}
+
+// fallen and raised trunk at the same distance: too low to stand or crouch
+// through, a jump over the fallen one hits the raised one
+std::vector<ObstacleSpawn> wall(float distance) {
+    std::vector<ObstacleSpawn> obstacles(2);
+    obstacles[0].kind = ObstacleKind::DOWN_TRUNK;
+    obstacles[1].kind = ObstacleKind::UP_TRUNK;
+    for (ObstacleSpawn &obstacle : obstacles) {
+        obstacle.lane = obstacleTraits(obstacle.kind).lane;
+        obstacle.distance = distance;
+    }
+    return obstacles;
+}
+
+bool advance(SolvabilityChecker &checker, float startDistance, const std::vector<ObstacleSpawn> &obstacles,
+             SolvabilityChecker::StateSet &reach) {
+    return checker.advance(startDistance, obstacles.data(), static_cast<int>(obstacles.size()), reach);
+}
+
+// every pattern at both jitter extremes and in every lane a random lane can
+// take, from standing in any lane one free chunk earlier, as ChunkGenerator
+// starts the run. A fallen trunk on the near edge cannot be jumped from a
+// standing start right at the edge. The empty chunk after the pattern must
+// pass too, the pattern's last steps are only checked with it.
+void patternsAccepted() {
+    for (int p = 0; p < OBSTACLE_PATTERN_COUNT; p++) {
+        const ObstaclePattern &pattern = OBSTACLE_PATTERNS[p];
+        const float shifts[] = {-pattern.jitter, 0.0f, pattern.jitter};
+        for (float shift : shifts) {
+            for (int lane = 0; lane < static_cast<int>(LANES.size()); lane++) {
+                SolvabilityChecker checker = makeChecker();
+                SolvabilityChecker::StateSet reach = checker.groundStates();
+                expect(advance(checker, START_DISTANCE - CHUNK_LENGTH, std::vector<ObstacleSpawn>(), reach),
+                       "RUN_UP_REJECTED", p);
+                std::vector<ObstacleSpawn> obstacles = layOut(pattern, START_DISTANCE, shift, lane);
+                expect(advance(checker, START_DISTANCE, obstacles, reach), "PATTERN_REJECTED", p);
+                expect(advance(checker, START_DISTANCE + CHUNK_LENGTH, obstacles, reach), "PATTERN_EXIT_REJECTED",
+                       p);
+            }
+        }
+    }
+}
+
+void wallRejected() {
+    SolvabilityChecker checker = makeChecker();
+    SolvabilityChecker::StateSet reach = checker.groundStates();
+    SolvabilityChecker::StateSet before = reach;
+    expect(!advance(checker, START_DISTANCE, wall(START_DISTANCE + 0.5f * CHUNK_LENGTH), reach), "WALL_ACCEPTED",
+           -1);
+    expect(reach == before, "REACH_CHANGED_BY_REJECT", -1);
+
+    // reach left alone is still good for the chunk that is drawn instead
+    expect(advance(checker, START_DISTANCE, std::vector<ObstacleSpawn>(), reach), "RETRY_REJECTED", -1);
+}
+
+// a wall on the boundary blocks whichever chunk owns it. Owned by the near
+// chunk it reaches into the next one and has to be passed on with it; the
+// near chunk's last lagSteps steps are only checked then.
+void boundaryWall() {
+    float boundary = START_DISTANCE + CHUNK_LENGTH;
+
+    SolvabilityChecker checker = makeChecker();
+    SolvabilityChecker::StateSet reach = checker.groundStates();
+    expect(advance(checker, START_DISTANCE, std::vector<ObstacleSpawn>(), reach), "EMPTY_REJECTED", -1);
+    expect(!advance(checker, boundary, wall(boundary), reach), "FAR_OWNED_WALL_ACCEPTED", -1);
+
+    checker = makeChecker();
+    reach = checker.groundStates();
+    std::vector<ObstacleSpawn> nearOwned = wall(boundary);
+    expect(advance(checker, START_DISTANCE, nearOwned, reach), "WALL_NOT_DEFERRED", -1);
+    SolvabilityChecker::StateSet deferred = reach;
+    expect(!advance(checker, boundary, nearOwned, reach), "NEAR_OWNED_WALL_ACCEPTED", -1);
+    // the states carried over really are stopped by the wall, not by
+    // anything else in the next chunk
+    expect(advance(checker, boundary, std::vector<ObstacleSpawn>(), deferred), "BLOCKED_WITHOUT_WALL", -1);
+}
+
+} // namespace
+
+int main() {
+    patternsAccepted();
+    wallRejected();
+    boundaryWall();
+
+    if (failures) {
+        return 1;
+    }
+    std::printf("SOLVABILITY_CHECKER_TEST:: passed, %d patterns\n", OBSTACLE_PATTERN_COUNT);
+    return 0;
+}
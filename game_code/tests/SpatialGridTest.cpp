@@ -0,0 +1,190 @@
+// Checks the three SpatialGrid queries against a scan of every live box.
+// The ring is only 8 rows of 1 unit while the boxes spread over 100 units
+// of z, so most rows are shared by boxes far apart; some boxes and queries
+// are longer than the whole ring. Coordinates are multiples of 1/8, so
+// boxes often end exactly on a lane edge or a row boundary.
+
+#include "SpatialGrid.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+class SpatialGridTest {
+public:
+    static void setStamp(SpatialGrid &grid, unsigned int stamp) { grid.stamp = stamp; }
+};
+
+namespace {
+
+const std::vector<float> LANES = {-0.5f, 0.0f, 0.5f};
+const float BUCKET_DEPTH = 1.0f;
+const int BUCKET_COUNT = 8;
+const int CAPACITY = 64;
+
+struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+    bool live;
+};
+
+int failures = 0;
+
+void fail(const char *what, int step) {
+    if (failures < 20) {
+        std::printf("ERROR::SPATIAL_GRID_TEST::%s step %d\n", what, step);
+    }
+    failures++;
+}
+
+float gridCoordinate(std::mt19937 &rng, int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng) * 0.125f;
+}
+
+Box randomBox(std::mt19937 &rng) {
+    Box box;
+    box.min.x = gridCoordinate(rng, -8, 6);
+    box.min.y = gridCoordinate(rng, -2, 4);
+    box.min.z = gridCoordinate(rng, -800, 0);
+    // mostly obstacle sized, now and then wide across all lanes or longer
+    // than the ring
+    int shape = std::uniform_int_distribution<int>(0, 9)(rng);
+    float width = shape == 0 ? 2.0f : gridCoordinate(rng, 0, 3);
+    float depth = shape == 1 ? gridCoordinate(rng, 64, 120) : gridCoordinate(rng, 0, 6);
+    box.max = box.min + glm::vec3(width, gridCoordinate(rng, 0, 3), depth);
+    box.live = true;
+    return box;
+}
+
+// same rule as the grid: x on an edge belongs to the lane above it
+int laneOf(float x) {
+    int lane = 0;
+    for (std::size_t i = 1; i < LANES.size(); i++) {
+        if (x >= 0.5f * (LANES[i - 1] + LANES[i])) {
+            lane++;
+        }
+    }
+    return lane;
+}
+
+std::vector<int> expectBox(const std::vector<Box> &boxes, const glm::vec3 &min, const glm::vec3 &max) {
+    std::vector<int> ids;
+    for (std::size_t id = 0; id < boxes.size(); id++) {
+        const Box &box = boxes[id];
+        if (box.live && min.x <= box.max.x && max.x >= box.min.x && min.y <= box.max.y && max.y >= box.min.y &&
+            min.z <= box.max.z && max.z >= box.min.z) {
+            ids.push_back(static_cast<int>(id));
+        }
+    }
+    return ids;
+}
+
+std::vector<int> expectRadius(const std::vector<Box> &boxes, const glm::vec3 &center, float radius) {
+    std::vector<int> ids;
+    for (std::size_t id = 0; id < boxes.size(); id++) {
+        const Box &box = boxes[id];
+        glm::vec3 offset = glm::clamp(center, box.min, box.max) - center;
+        if (box.live && glm::dot(offset, offset) <= radius * radius) {
+            ids.push_back(static_cast<int>(id));
+        }
+    }
+    return ids;
+}
+
+std::vector<int> expectRange(const std::vector<Box> &boxes, int lane, float z0, float z1) {
+    std::vector<int> ids;
+    for (std::size_t id = 0; id < boxes.size(); id++) {
+        const Box &box = boxes[id];
+        bool inLane = lane < 0 || (laneOf(box.min.x) <= lane && laneOf(box.max.x) >= lane);
+        if (box.live && inLane && box.min.z <= std::max(z0, z1) && box.max.z >= std::min(z0, z1)) {
+            ids.push_back(static_cast<int>(id));
+        }
+    }
+    return ids;
+}
+
+// the query appends after what out already holds, each id once
+void compare(const char *what, int step, std::vector<int> &out, std::vector<int> expected) {
+    if (out.empty() || out[0] != -1) {
+        fail("OVERWROTE_OUTPUT", step);
+        return;
+    }
+    std::vector<int> found(out.begin() + 1, out.end());
+    std::sort(found.begin(), found.end());
+    if (std::adjacent_find(found.begin(), found.end()) != found.end()) {
+        fail("DUPLICATE_ID", step);
+    }
+    if (found != expected) {
+        fail(what, step);
+    }
+}
+
+void runQueries(SpatialGrid &grid, const std::vector<Box> &boxes, std::mt19937 &rng, int step) {
+    std::vector<int> out;
+
+    Box query = randomBox(rng);
+    out.assign(1, -1);
+    grid.queryBox(query.min, query.max, out);
+    compare("QUERY_BOX", step, out, expectBox(boxes, query.min, query.max));
+
+    float radius = gridCoordinate(rng, 0, 24);
+    out.assign(1, -1);
+    grid.queryRadius(query.min, radius, out);
+    compare("QUERY_RADIUS", step, out, expectRadius(boxes, query.min, radius));
+
+    int lane = std::uniform_int_distribution<int>(-1, 2)(rng);
+    float z0 = gridCoordinate(rng, -800, 0);
+    float z1 = z0 + gridCoordinate(rng, -100, 100);
+    out.assign(1, -1);
+    grid.queryRange(lane, z0, z1, out);
+    compare("QUERY_RANGE", step, out, expectRange(boxes, lane, z0, z1));
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(777u);
+    SpatialGrid grid(LANES, BUCKET_DEPTH, BUCKET_COUNT, CAPACITY);
+    std::vector<Box> boxes(CAPACITY);
+    for (Box &box : boxes) {
+        box.live = false;
+    }
+
+    // random inserts, re-inserts of live ids and removes
+    for (int step = 0; step < 3000; step++) {
+        int id = std::uniform_int_distribution<int>(0, CAPACITY - 1)(rng);
+        if (boxes[id].live && std::uniform_int_distribution<int>(0, 2)(rng) == 0) {
+            grid.remove(id);
+            boxes[id].live = false;
+        } else {
+            boxes[id] = randomBox(rng);
+            grid.insert(id, boxes[id].min, boxes[id].max);
+        }
+        runQueries(grid, boxes, rng, step);
+    }
+
+    // stamp wrap-around: the whole track is gathered with stamp 1, then
+    // again with the stamp wrapping back to 1, which only finds the ids
+    // when the old stamps were cleared
+    for (int pass = 0; pass < 2; pass++) {
+        SpatialGridTest::setStamp(grid, pass == 0 ? 0u : UINT_MAX);
+        std::vector<int> out(1, -1);
+        grid.queryRange(-1, -1000.0f, 1000.0f, out);
+        compare("STAMP_WRAP", pass, out, expectRange(boxes, -1, -1000.0f, 1000.0f));
+        runQueries(grid, boxes, rng, pass);
+    }
+
+    grid.clear();
+    for (Box &box : boxes) {
+        box.live = false;
+    }
+    runQueries(grid, boxes, rng, -1);
+
+    if (failures) {
+        return 1;
+    }
+    std::printf("SPATIAL_GRID_TEST:: passed\n");
+    return 0;
+}